@@ -0,0 +1,67 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <thread>
+
+#include "icalendar.h"
+#include "parser.h"
+#include "synthetic.h"
+
+/* measure - run a function for a number of rounds and report the results
+ * @name: name of the measurement
+ * @rounds: number of rounds
+ * @f: the function, returns the number of events found
+ */
+template<typename F>
+static void measure(const char* name, unsigned rounds, F f)
+{
+	std::size_t found = 0;
+	const unsigned long allocations_before = bench::allocations();
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned i = 0; i < rounds; i++)
+		found = f();
+
+	const auto end = std::chrono::steady_clock::now();
+	const unsigned long used = bench::allocations() - allocations_before;
+	const auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(end - start);
+
+	std::cout << name << " events: " << found << '\n'
+		  << name << " us/feed: " << elapsed.count() / rounds << '\n'
+		  << name << " allocations/feed: "
+		  << static_cast<double>(used) / rounds << '\n';
+}
+
+int main(int argc, const char** argv)
+{
+	const unsigned rounds = argc > 1 ? std::stoul(argv[1]) : 20;
+	const unsigned count = argc > 2 ? std::stoul(argv[2]) : 10000;
+	const unsigned threads = argc > 3 ? std::stoul(argv[3]) :
+		std::thread::hardware_concurrency();
+
+	const std::string feed = bench::synthetic_ics(count, util::now());
+	const events::parser::time_window upcoming{util::now()};
+
+	std::cout << "events: " << count << '\n'
+		  << "bytes: " << feed.size() << '\n'
+		  << "rounds: " << rounds << '\n'
+		  << "threads: " << threads << '\n';
+
+	measure("tree", rounds, [&feed]() {
+		return icalendar::parse(feed).subnodes["VEVENT"].size();
+	});
+
+	measure("all", rounds, [&feed]() {
+		return events::parser::events_from_ics(feed).size();
+	});
+
+	measure("upcoming", rounds, [&feed, &upcoming]() {
+		return events::parser::events_from_ics(feed, upcoming).size();
+	});
+
+	measure("parallel", rounds, [&feed, threads]() {
+		return events::parser::events_from_ics(feed, {}, threads).size();
+	});
+
+	return 0;
+}
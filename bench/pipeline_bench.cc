@@ -0,0 +1,125 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "buffer_target.h"
+#include "event_model.h"
+#include "event_view.h"
+#include "icalendar.h"
+#include "layout.h"
+#include "parser.h"
+#include "synthetic.h"
+#include "ui.h"
+
+/* measure - run a benchmark and print the results as a csv row
+ * @name: name of the benchmark
+ * @count: number of events
+ * @min_time: the benchmark is repeated at least this long
+ * @f: the benchmark, returns the number of items it produced
+ *
+ * The first run is not measured so that it can fill the caches.
+ */
+template<typename F>
+static void measure(const char* name,
+		    unsigned count,
+		    std::chrono::milliseconds min_time,
+		    F f)
+{
+	std::size_t items = f();
+	unsigned long rounds = 0;
+
+	const unsigned long allocations_before = bench::allocations();
+	const auto start = std::chrono::steady_clock::now();
+	auto end = start;
+
+	do {
+		items = f();
+		rounds++;
+		end = std::chrono::steady_clock::now();
+	} while (end - start < min_time);
+
+	const unsigned long used = bench::allocations() - allocations_before;
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+	std::cout << name << ','
+		  << count << ','
+		  << items << ','
+		  << rounds << ','
+		  << elapsed.count() / rounds << ','
+		  << static_cast<double>(used) / rounds << std::endl;
+}
+
+int main(int argc, const char** argv)
+{
+	const std::chrono::milliseconds min_time{argc > 1 ? std::stoul(argv[1]) : 200};
+	std::vector<unsigned> counts;
+
+	for (int i = 2; i < argc; i++)
+		counts.push_back(std::stoul(argv[i]));
+
+	if (counts.empty())
+		counts = {10, 1000, 100000};
+
+	ui::buffer_target target{{160, 48}};
+	ui::screen_init(&target);
+
+	std::cout << "benchmark,events,items,rounds,ns/round,allocations/round"
+		  << std::endl;
+
+	for (const unsigned count : counts) {
+		const auto now = util::now();
+		const std::string ics = bench::synthetic_ics(count, now);
+		const std::string json = bench::synthetic_json(count, now);
+		const events::parser::time_window window{now};
+
+		measure("icalendar_parse", count, min_time, [&ics]() {
+			return icalendar::parse(ics).subnodes["VEVENT"].size();
+		});
+
+		measure("events_from_ics", count, min_time, [&ics, &window]() {
+			return events::parser::events_from_ics(ics, window).size();
+		});
+
+		measure("events_from_json", count, min_time, [&json, &window]() {
+			return events::parser::events_from_json(json, window).size();
+		});
+
+		// The backend provides its events on every update, so the
+		// model merges all of them every time
+		{
+			events::event_model model;
+			model.add_source(std::make_shared<bench::synthetic_backend>(
+					 bench::synthetic_events(count, now), true));
+
+			measure("event_model_update", count, min_time, [&model]() {
+				model.update();
+				return model.events().size();
+			});
+		}
+
+		{
+			events::event_model model;
+			model.add_source(std::make_shared<bench::synthetic_backend>(
+					 bench::synthetic_events(count, now), false));
+			model.update();
+
+			events::event_view view;
+			view.set_model(&model);
+
+			ui::layout layout;
+			layout.add_view(&view);
+			layout.set_screen_size(ui::screen_size());
+
+			measure("event_view_draw", count, min_time, [&layout, &model]() {
+				layout.draw();
+				return model.events().size();
+			});
+		}
+	}
+
+	ui::screen_deinit();
+
+	return 0;
+}
@@ -0,0 +1,66 @@
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "buffer_target.h"
+#include "event_model.h"
+#include "event_view.h"
+#include "layout.h"
+#include "status_view.h"
+#include "synthetic.h"
+#include "ui.h"
+
+int main(int argc, const char** argv)
+{
+	const unsigned frames = argc > 1 ? std::stoul(argv[1]) : 1000;
+	const unsigned width = argc > 2 ? std::stoul(argv[2]) : 160;
+	const unsigned height = argc > 3 ? std::stoul(argv[3]) : 48;
+	constexpr unsigned event_count = 1000;
+
+	ui::buffer_target target{{width, height}};
+	ui::screen_init(&target);
+
+	events::event_model model;
+	model.add_source(std::make_shared<bench::synthetic_backend>(
+			 bench::synthetic_events(event_count, util::now()), false));
+	model.update();
+
+	util::status_view status;
+	status.set_system_message(L"Benchmarking");
+
+	events::event_view view;
+	view.set_model(&model);
+
+	ui::layout layout;
+	layout.add_view(&status, ui::layout::all_columns);
+	layout.add_view(&view);
+	layout.set_screen_size(ui::screen_size());
+
+	// The first frame fills the caches
+	status.set_system_time(util::now());
+	layout.draw();
+
+	const unsigned long allocations_before = bench::allocations();
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned i = 0; i < frames; i++) {
+		status.set_system_time(util::now());
+		layout.draw();
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	const unsigned long frame_allocations = bench::allocations() - allocations_before;
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+	std::cout << "events: " << event_count << '\n'
+		  << "screen: " << width << 'x' << height << '\n'
+		  << "frames: " << frames << '\n'
+		  << "ns/frame: " << elapsed.count() / frames << '\n'
+		  << "allocations/frame: "
+		  << static_cast<double>(frame_allocations) / frames << '\n';
+
+	ui::screen_deinit();
+
+	return 0;
+}
@@ -0,0 +1,201 @@
+#include "synthetic.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <utility>
+
+using namespace std::chrono;
+
+/* allocation_count - number of allocations done since the program started */
+static std::atomic<unsigned long> allocation_count{0};
+
+void* operator new(std::size_t size)
+{
+	allocation_count++;
+
+	if (void* ptr = std::malloc(size ? size : 1))
+		return ptr;
+
+	throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+	std::free(ptr);
+}
+
+void operator delete(void* ptr, std::size_t) noexcept
+{
+	std::free(ptr);
+}
+
+/* basic_time - format a local time in the basic format used by POP */
+static std::string basic_time(util::time_point time);
+/* rfc3339_time - format a time with the offset used by Google */
+static std::string rfc3339_time(util::time_point time);
+/* date - format the local date of a time */
+static std::string date(util::time_point time);
+
+unsigned long
+bench::allocations()
+{
+	return allocation_count;
+}
+
+std::string
+bench::synthetic_ics(unsigned count, util::time_point now)
+{
+	const auto first = now - hours(24*60);
+	const auto step = seconds(hours(24*90)) / std::max(count, 1u);
+	std::string feed;
+
+	feed += "BEGIN:VCALENDAR\r\n"
+		"PRODID:TUT.FI//POP-CALENDARSERVICE_V1.0//FI\r\n"
+		"VERSION:2.0\r\n";
+
+	for (unsigned i = 0; i < count; i++) {
+		const auto start = first + step*i;
+
+		feed += "BEGIN:VEVENT\r\n"
+			"DTSTAMP:20180101T000000Z\r\n"
+			"DTSTART;TZID=Europe/Helsinki:" + basic_time(start) + "\r\n"
+			"DTEND;TZID=Europe/Helsinki:" + basic_time(start + minutes(90)) + "\r\n"
+			"SUMMARY:Synthetic lecture number " + std::to_string(i) + "\r\n"
+			"LOCATION:Room " + std::to_string(i % 17) + "\\, Building\r\n"
+			"UID:event-" + std::to_string(i) + "\r\n"
+			"DESCRIPTION:Synthetic description of the lecture\\, "
+			"long enough to be a realistic one\r\n"
+			"STATUS:CONFIRMED\r\n"
+			"END:VEVENT\r\n";
+	}
+
+	feed += "END:VCALENDAR\r\n";
+
+	return feed;
+}
+
+std::string
+bench::synthetic_json(unsigned count, util::time_point now)
+{
+	const auto step = seconds(hours(24*30)) / std::max(count, 1u);
+	std::string feed;
+
+	feed += "{\n"
+		"\t\"kind\": \"calendar#events\",\n"
+		"\t\"items\": [";
+
+	for (unsigned i = 0; i < count; i++) {
+		const auto start = now + step*i;
+		std::string start_time;
+		std::string end_time;
+
+		if (i % 10 == 9) {
+			start_time = "\"date\": \"" + date(start) + "\"";
+			end_time = "\"date\": \"" + date(start + hours(24)) + "\"";
+		} else {
+			start_time = "\"dateTime\": \"" + rfc3339_time(start) + "\"";
+			end_time = "\"dateTime\": \"" + rfc3339_time(start + minutes(90)) + "\"";
+		}
+
+		feed += i ? ",\n" : "\n";
+		feed += "\t\t{\n"
+			"\t\t\t\"kind\": \"calendar#event\",\n"
+			"\t\t\t\"status\": \"confirmed\",\n"
+			"\t\t\t\"summary\": \"Synthetic meeting number " + std::to_string(i) + "\",\n"
+			"\t\t\t\"description\": \"Synthetic description of the meeting\",\n"
+			"\t\t\t\"location\": \"Room " + std::to_string(i % 17) + "\",\n"
+			"\t\t\t\"iCalUID\": \"event-" + std::to_string(i) + "\",\n"
+			"\t\t\t\"start\": {" + start_time + "},\n"
+			"\t\t\t\"end\": {" + end_time + "}\n"
+			"\t\t}";
+	}
+
+	feed += "\n\t]\n}\n";
+
+	return feed;
+}
+
+std::list<events::event>
+bench::synthetic_events(unsigned count, util::time_point now)
+{
+	std::list<events::event> events;
+
+	for (unsigned i = 0; i < count; i++) {
+		const auto start = now + minutes(30*i);
+
+		events.emplace_back(L"Synthetic event number " +
+				    std::to_wstring(i),
+				    start,
+				    start + minutes(45));
+
+		if (i % 2)
+			events.back().set_location(L"Room " +
+						   std::to_wstring(i % 17));
+	}
+
+	return events;
+}
+
+bench::synthetic_backend::synthetic_backend(std::list<events::event> events,
+					    bool repeat) :
+	events_{std::move(events)},
+	repeat_{repeat},
+	updated_{false}
+{}
+
+void
+bench::synthetic_backend::lower_cooldown()
+{}
+
+std::optional<std::list<events::event>>
+bench::synthetic_backend::update()
+{
+	updated_ = true;
+
+	return events_;
+}
+
+bool
+bench::synthetic_backend::ready() const
+{
+	return repeat_ or not updated_;
+}
+
+static std::string
+basic_time(util::time_point time)
+{
+	const auto c = util::to_local(time);
+	char buf[16];
+
+	std::snprintf(buf, sizeof(buf), "%04d%02u%02uT%02u%02u%02u",
+		      c.year, c.month, c.day, c.hour, c.minute, c.second);
+
+	return buf;
+}
+
+static std::string
+rfc3339_time(util::time_point time)
+{
+	// Google uses the time zone of the calendar, here always +02:00
+	const auto c = util::to_utc(time + hours(2));
+	char buf[32];
+
+	std::snprintf(buf, sizeof(buf), "%04d-%02u-%02uT%02u:%02u:%02u+02:00",
+		      c.year, c.month, c.day, c.hour, c.minute, c.second);
+
+	return buf;
+}
+
+static std::string
+date(util::time_point time)
+{
+	const auto c = util::to_local(time);
+	char buf[16];
+
+	std::snprintf(buf, sizeof(buf), "%04d-%02u-%02u", c.year, c.month, c.day);
+
+	return buf;
+}
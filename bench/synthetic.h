@@ -0,0 +1,66 @@
+#pragma once
+
+#include <list>
+#include <optional>
+#include <string>
+
+#include "event.h"
+#include "event_backend_interface.h"
+#include "local_time.h"
+
+namespace bench {
+	/* allocations - get the number of allocations
+	 *
+	 * Returns the number of times operator new has been called since the
+	 * program started.
+	 */
+	unsigned long allocations();
+
+	/* synthetic_ics - generate a feed like the one provided by POP
+	 * @count: number of events
+	 * @now: the current time
+	 *
+	 * The events cover two months before now and one after it like the
+	 * real feed does.
+	 */
+	std::string synthetic_ics(unsigned count, util::time_point now);
+	/* synthetic_json - generate a feed like the one provided by Google
+	 * @count: number of events
+	 * @now: the current time
+	 *
+	 * The events start after now like the ones requested from Google.
+	 * Every tenth event is an all day event.
+	 */
+	std::string synthetic_json(unsigned count, util::time_point now);
+	/* synthetic_events - generate events
+	 * @count: number of events
+	 * @now: the current time
+	 *
+	 * The events start every 30 minutes after now and every other one has
+	 * a location.
+	 */
+	std::list<events::event> synthetic_events(unsigned count,
+						  util::time_point now);
+
+	/* synthetic_backend class
+	 * This class provides a fixed list of events
+	 */
+	class synthetic_backend : public events::event_backend_interface {
+	public:
+		/* synthetic_backend - ctor
+		 * @events: the events provided
+		 * @repeat: provide the events on every update instead of
+		 *          only the first one
+		 */
+		synthetic_backend(std::list<events::event> events, bool repeat);
+
+		void lower_cooldown() override;
+		std::optional<std::list<events::event>> update() override;
+		bool ready() const override;
+
+	private:
+		std::list<events::event> events_;
+		bool repeat_;
+		bool updated_;
+	};
+}
@@ -0,0 +1,98 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include <boost/date_time.hpp>
+
+#include "synthetic.h"
+#include "timestamp.h"
+
+using boost::posix_time::from_iso_string;
+using boost::posix_time::ptime;
+using boost::posix_time::time_from_string;
+
+/* boost_datetime - the json timestamp parsing used before parse_timestamp */
+static long long boost_datetime(const std::string& src)
+{
+	auto temp{src};
+
+	temp.replace(temp.find_first_of('T'), 1, 1, ' ');
+	temp.erase(temp.find_first_of('+'));
+
+	return time_from_string(temp).time_of_day().total_seconds();
+}
+
+/* second_of_day - parse a timestamp with parse_timestamp */
+static long long second_of_day(const std::string& src)
+{
+	events::parser::timestamp t;
+
+	events::parser::parse_timestamp(src, t);
+
+	return t.time.hour*3600 + t.time.minute*60 + t.time.second;
+}
+
+/* measure - run a parser over the inputs and print the results
+ * @name: name of the parser
+ * @inputs: the timestamps
+ * @rounds: how many times the inputs are parsed
+ * @parse: the parser, returns the second of the day
+ */
+template<typename Parser>
+static void measure(const char* name,
+		    const std::vector<std::string>& inputs,
+		    unsigned rounds,
+		    Parser parse)
+{
+	long long checksum = 0;
+
+	const unsigned long allocations_before = bench::allocations();
+	const auto start = std::chrono::steady_clock::now();
+
+	for (unsigned i = 0; i < rounds; i++) {
+		for (const auto& input : inputs)
+			checksum += parse(input);
+	}
+
+	const auto end = std::chrono::steady_clock::now();
+	const unsigned long count = static_cast<unsigned long>(rounds)*inputs.size();
+	const auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(end - start);
+
+	std::cout << name << " ns/timestamp: " << elapsed.count() / count << '\n'
+		  << name << " allocations/timestamp: "
+		  << static_cast<double>(bench::allocations() - allocations_before) / count << '\n'
+		  << name << " checksum: " << checksum << '\n';
+}
+
+int main(int argc, const char** argv)
+{
+	const unsigned rounds = argc > 1 ? std::stoul(argv[1]) : 1000;
+	constexpr unsigned input_count = 1000;
+
+	std::vector<std::string> extended;
+	std::vector<std::string> basic;
+
+	// The offset is the one of the local time zone so that both parsers
+	// agree on the results
+	for (unsigned i = 0; i < input_count; i++) {
+		const ptime t{boost::gregorian::date{2018, boost::gregorian::Jan, 1} +
+			      boost::gregorian::days(i % 28),
+			      boost::posix_time::minutes(17*i % (24*60))};
+
+		extended.push_back(boost::posix_time::to_iso_extended_string(t) + "+00:00");
+		basic.push_back(boost::posix_time::to_iso_string(t));
+	}
+
+	std::cout << "timestamps: " << input_count << '\n'
+		  << "rounds: " << rounds << '\n';
+
+	measure("json boost", extended, rounds, boost_datetime);
+	measure("json parse_timestamp", extended, rounds, second_of_day);
+	measure("ics boost", basic, rounds, [](const std::string& s) {
+		return from_iso_string(s).time_of_day().total_seconds();
+	});
+	measure("ics parse_timestamp", basic, rounds, second_of_day);
+
+	return 0;
+}
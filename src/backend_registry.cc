@@ -0,0 +1,229 @@
+#include "backend_registry.h"
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <stdexcept>
+#include <string>
+#include <utility>
+
+#include <unistd.h>
+
+#include "file_backend.h"
+#include "google_calendar_backend.h"
+#include "pipe_backend.h"
+#include "pop_calendar_backend.h"
+#include "subscription_backend.h"
+
+/* create_google - create a backend for --google-api */
+static events::backend_registry::created
+create_google(const std::vector<std::string>& values);
+/* create_pop - create a backend for --pop-api */
+static events::backend_registry::created
+create_pop(const std::vector<std::string>& values);
+/* cooldowns - get the settings of a backend with cooldowns
+ * @cooldown: the cooldown of the backend
+ * @error_cooldown: the error cooldown of the backend
+ */
+static std::string cooldowns(std::chrono::seconds cooldown,
+			     std::chrono::seconds error_cooldown);
+/* wrong_amount - get the error for a wrong amount of arguments
+ * @option: name of the option
+ */
+static std::invalid_argument wrong_amount(const std::string& option);
+
+void
+events::backend_registry::add(const std::string& option,
+			      const std::string& help,
+			      factory create)
+{
+	if (contains(option))
+		throw std::logic_error{"backend option registered twice"};
+
+	entries_.push_back(entry{option, help, std::move(create)});
+}
+
+bool
+events::backend_registry::contains(const std::string& option) const
+{
+	return std::any_of(entries_.begin(), entries_.end(),
+			   [&option](const entry& e) {
+		return e.option == option;
+	});
+}
+
+events::backend_registry::created
+events::backend_registry::create(const std::string& option,
+				 const std::vector<std::string>& values) const
+{
+	const auto it = std::find_if(entries_.begin(), entries_.end(),
+				     [&option](const entry& e) {
+		return e.option == option;
+	});
+
+	if (it == entries_.end())
+		throw std::out_of_range{"unknown backend option"};
+
+	return it->create(values);
+}
+
+const std::vector<events::backend_registry::entry>&
+events::backend_registry::entries() const
+{
+	return entries_;
+}
+
+void
+events::add_default_backends(backend_registry& registry)
+{
+	registry.add("pop-api",
+		     "  --pop-api <url> [ <cd> <ecd> ]\n"
+		     "                         Add a POP backend with the <url> pointing to the ics\n"
+		     "                         resource. <cd> is the cooldown period in seconds and\n"
+		     "                         <ecd> is the cooldown period used if the connection\n"
+		     "                         to server failed.\n",
+		     create_pop);
+	registry.add("google-api",
+		     "  --google-api <id> <key> [ <cd> <ecd> ]\n"
+		     "                         Add a Google backend with the calendar id <id> and API\n"
+		     "                         key <key>. <cd> is the cooldown period in seconds\n"
+		     "                         and <ecd> is the cooldown period used if the connection\n"
+		     "                         to server failed.\n",
+		     create_google);
+	registry.add("file",
+		     "  --file <path>          Add a backend reading an ics or Google json file from\n"
+		     "                         <path>. The file is read again whenever it changes.\n",
+		     [](const std::vector<std::string>& values) -> backend_registry::created {
+		if (values.size() != 1)
+			throw wrong_amount("file");
+
+		// Accept file:// urls as well as plain paths
+		const std::string prefix = "file://";
+		std::string path = values[0];
+
+		if (path.compare(0, prefix.size(), prefix) == 0)
+			path.erase(0, prefix.size());
+
+		return {"file:" + path, std::make_shared<file_backend>(path), false};
+	});
+	registry.add("pipe",
+		     "  --pipe <path>          Add a backend reading ics or Google json data from the\n"
+		     "                         named pipe <path>, or from the standard input if\n"
+		     "                         <path> is '-'. The standard input has to be\n"
+		     "                         redirected as the terminal belongs to the display.\n"
+		     "                         The data is parsed every time the writing end is\n"
+		     "                         closed.\n",
+		     [](const std::vector<std::string>& values) -> backend_registry::created {
+		if (values.size() != 1)
+			throw wrong_amount("pipe");
+
+		// Curses takes over the terminal, so the data can't be typed in
+		// and reading it would steal the input of the display
+		if (values[0] == "-" and isatty(STDIN_FILENO))
+			throw std::invalid_argument{"--pipe - needs the standard input "
+						    "redirected from a pipe or a file"};
+
+		return {"pipe:" + values[0], std::make_shared<pipe_backend>(values[0]), false};
+	});
+	registry.add("subscribe",
+		     "  --subscribe <path>     Add a backend showing the events another instance\n"
+		     "                         writes to <path> with --dump-events.\n",
+		     [](const std::vector<std::string>& values) -> backend_registry::created {
+		if (values.size() != 1)
+			throw wrong_amount("subscribe");
+
+		return {"subscribe:" + values[0],
+			std::make_shared<subscription_backend>(values[0]),
+			false};
+	});
+}
+
+std::string
+events::canonical_url(const std::string& url)
+{
+	std::string canonical = url;
+
+	const auto scheme_end = canonical.find("://");
+
+	if (scheme_end == std::string::npos)
+		return canonical;
+
+	// The scheme and the host end at the first slash after "://"
+	const auto host_end = canonical.find('/', scheme_end + 3);
+
+	std::transform(canonical.begin(),
+		       host_end == std::string::npos ? canonical.end() :
+						       canonical.begin() + host_end,
+		       canonical.begin(),
+		       [](unsigned char c) { return std::tolower(c); });
+
+	return canonical;
+}
+
+static std::string
+cooldowns(std::chrono::seconds cooldown, std::chrono::seconds error_cooldown)
+{
+	return "cooldown " + std::to_string(cooldown.count()) +
+	       ", error cooldown " + std::to_string(error_cooldown.count());
+}
+
+static events::backend_registry::created
+create_google(const std::vector<std::string>& values)
+{
+	if (values.size() != 2 and values.size() != 4)
+		throw wrong_amount("google-api");
+
+	auto backend = std::make_shared<events::google_calendar_backend>();
+
+	backend->set_id(values[0]);
+	backend->set_key(values[1]);
+
+	if (values.size() == 4) {
+		try {
+			backend->set_cooldown(std::stoi(values[2]));
+			backend->set_error_cooldown(std::stoi(values[3]));
+		} catch (const std::exception& e) {
+			throw std::invalid_argument{"Invalid cooldown argument for --google-api"};
+		}
+	}
+
+	// The same calendar read with another API key is another backend
+	// only in name, so the key has to match as well
+	const auto settings = cooldowns(backend->cooldown(), backend->error_cooldown()) +
+			      ", API key " + values[1];
+
+	return {"google:" + values[0], std::move(backend), true, settings};
+}
+
+static events::backend_registry::created
+create_pop(const std::vector<std::string>& values)
+{
+	if (values.size() != 1 and values.size() != 3)
+		throw wrong_amount("pop-api");
+
+	auto backend = std::make_shared<events::pop_calendar_backend>();
+
+	backend->set_url(values[0]);
+
+	if (values.size() == 3) {
+		try {
+			backend->set_cooldown(std::stoi(values[1]));
+			backend->set_error_cooldown(std::stoi(values[2]));
+		} catch (const std::exception& e) {
+			throw std::invalid_argument{"Invalid cooldown argument for --pop-api"};
+		}
+	}
+
+	const auto settings = cooldowns(backend->cooldown(), backend->error_cooldown());
+
+	return {"pop:" + events::canonical_url(values[0]),
+		std::move(backend),
+		true,
+		settings};
+}
+
+static std::invalid_argument
+wrong_amount(const std::string& option)
+{
+	return std::invalid_argument{"Wrong amount of arguments for --" + option};
+}
@@ -0,0 +1,105 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "event_backend_interface.h"
+
+namespace events {
+/* backend_registry class
+ * This class maps commandline options to functions that create event
+ * backends. Every created backend comes with a key identifying the data it
+ * requests, so that backends with the same key can be shared.
+ */
+class backend_registry {
+public:
+	/* created struct
+	 * This struct holds a backend created by a factory
+	 *
+	 * @key: identifies the data requested by the backend
+	 * @backend: the backend
+	 * @remote: whether the backend fetches its data over the network
+	 * @settings: the options of the backend that aren't part of the key,
+	 *            e.g. its cooldowns. Two backends with the same key but
+	 *            different settings conflict.
+	 */
+	struct created {
+		std::string key;
+		std::shared_ptr<event_backend_interface> backend;
+		bool remote;
+		std::string settings = {};
+	};
+
+	/* factory - creates a backend from the values of an option
+	 *
+	 * Throws std::invalid_argument with a message for the user if the
+	 * values are not valid or std::runtime_error if the backend can't be
+	 * set up
+	 */
+	using factory = std::function<created(const std::vector<std::string>& values)>;
+
+	/* entry struct
+	 * This struct describes a registered backend
+	 *
+	 * @option: name of the commandline option without the dashes
+	 * @help: help text of the option formatted like the other options
+	 * @create: the function creating the backend
+	 */
+	struct entry {
+		std::string option;
+		std::string help;
+		factory create;
+	};
+
+	/* add - register a backend
+	 * @option: name of the commandline option without the dashes
+	 * @help: help text of the option
+	 * @create: the function creating the backend
+	 *
+	 * Throws std::logic_error if the option has already been registered
+	 */
+	void add(const std::string& option, const std::string& help, factory create);
+
+	/* contains - check if an option has been registered
+	 * @option: name of the option
+	 *
+	 * Returns true if the option creates a backend
+	 */
+	bool contains(const std::string& option) const;
+	/* create - create a backend
+	 * @option: name of the option
+	 * @values: values given to the option
+	 *
+	 * Returns the created backend. Throws std::out_of_range if the option
+	 * is not registered, otherwise passes on the exceptions of the
+	 * factory.
+	 */
+	created create(const std::string& option,
+		       const std::vector<std::string>& values) const;
+	/* entries - get the registered backends
+	 *
+	 * Returns a reference to the entries in the order they were added
+	 */
+	const std::vector<entry>& entries() const;
+
+protected:
+	std::vector<entry> entries_;
+};
+
+/* add_default_backends - register the backends of info-tv
+ * @registry: the registry to add the backends to
+ *
+ * Registers the --google-api, --pop-api, --file, --pipe and --subscribe
+ * options
+ */
+void add_default_backends(backend_registry& registry);
+/* canonical_url - get the canonical form of an url
+ * @url: the url
+ *
+ * Returns the url with the scheme and the host in lower case, so that
+ * backends requesting the same resource get the same key
+ */
+std::string canonical_url(const std::string& url);
+}
@@ -0,0 +1,216 @@
+#include "buffer_target.h"
+
+#include <algorithm>
+#include <stdexcept>
+#include <tuple>
+
+namespace ui {
+/* buffer_surface class
+ * This class implements a surface drawing into the grid of a buffer_target
+ */
+class buffer_surface : public surface {
+public:
+	/* buffer_surface - ctor
+	 * @target: the target owning the grid
+	 * @from: top left corner in grid coordinates
+	 * @to: bottom right corner in grid coordinates
+	 */
+	buffer_surface(buffer_target* target,
+		       std::pair<unsigned, unsigned> from,
+		       std::pair<unsigned, unsigned> to) :
+		attrs_{0},
+		target_{target},
+		from_{from},
+		to_{to}
+	{}
+
+	void
+	effect_off(unsigned attrs) override
+	{
+		attrs_ &= ~attrs;
+	}
+
+	void
+	effect_on(unsigned attrs) override
+	{
+		attrs_ |= attrs;
+	}
+
+	void
+	draw_border() override
+	{
+		const auto [left, top] = from_;
+		const auto [right, bottom] = to_;
+
+		if (right <= left or bottom <= top)
+			return;
+
+		for (unsigned x = left; x < right; x++) {
+			put(x, top, L'-');
+			put(x, bottom - 1, L'-');
+		}
+
+		for (unsigned y = top; y < bottom; y++) {
+			put(left, y, L'|');
+			put(right - 1, y, L'|');
+		}
+
+		put(left, top, L'+');
+		put(right - 1, top, L'+');
+		put(left, bottom - 1, L'+');
+		put(right - 1, bottom - 1, L'+');
+	}
+
+	void
+	clear_area() override
+	{
+		for (unsigned y = std::get<1>(from_); y < std::get<1>(to_); y++)
+			for (unsigned x = std::get<0>(from_); x < std::get<0>(to_); x++)
+				put(x, y, L' ', 0);
+	}
+
+	void
+	print(unsigned x, unsigned y, std::wstring_view text) override
+	{
+		for (const auto c : text) {
+			if (c == L'\0')
+				break;
+
+			put(std::get<0>(from_) + x++, std::get<1>(from_) + y, c);
+		}
+	}
+
+	void
+	print(unsigned x, unsigned y, std::string_view text) override
+	{
+		for (const auto c : text)
+			put(std::get<0>(from_) + x++,
+			    std::get<1>(from_) + y,
+			    static_cast<unsigned char>(c));
+	}
+
+	void
+	update() override
+	{
+		target_->refresh_count_++;
+	}
+
+	std::unique_ptr<surface>
+	subsurface(std::pair<unsigned, unsigned> from,
+		   std::pair<unsigned, unsigned> to) override
+	{
+		const auto [x, y] = from_;
+
+		// The subsurface can't reach outside of this surface
+		return std::make_unique<buffer_surface>(target_,
+							std::pair{x + std::get<0>(from),
+								  y + std::get<1>(from)},
+							std::pair{std::min(x + std::get<0>(to),
+									   std::get<0>(to_)),
+								  std::min(y + std::get<1>(to),
+									   std::get<1>(to_))});
+	}
+
+	void
+	touch() override
+	{}
+
+private:
+	/* put - set a cell
+	 * @x: x position in grid coordinates
+	 * @y: y position in grid coordinates
+	 * @ch: the character
+	 *
+	 * Cells outside of this surface or the grid are ignored
+	 */
+	void
+	put(unsigned x, unsigned y, wchar_t ch)
+	{
+		put(x, y, ch, attrs_);
+	}
+
+	/* put - set a cell using the given effects */
+	void
+	put(unsigned x, unsigned y, wchar_t ch, unsigned attrs)
+	{
+		if (x >= std::get<0>(to_) or y >= std::get<1>(to_) or
+		    x >= target_->width_ or y >= target_->height_)
+			return;
+
+		target_->cells_[y*target_->width_ + x] = {ch, attrs};
+	}
+
+	unsigned attrs_;
+	buffer_target* target_;
+	std::pair<unsigned, unsigned> from_;
+	std::pair<unsigned, unsigned> to_;
+};
+}
+
+ui::buffer_target::buffer_target(std::pair<unsigned, unsigned> size) :
+	refresh_count_{0}
+{
+	set_size(size);
+}
+
+const ui::buffer_target::cell&
+ui::buffer_target::at(unsigned x, unsigned y) const
+{
+	if (x >= width_ or y >= height_)
+		throw std::out_of_range{"cell is outside of the buffer"};
+
+	return cells_[y*width_ + x];
+}
+
+std::wstring
+ui::buffer_target::line(unsigned y) const
+{
+	if (y >= height_)
+		throw std::out_of_range{"line is outside of the buffer"};
+
+	std::wstring text;
+	text.reserve(width_);
+
+	for (unsigned x = 0; x < width_; x++)
+		text.push_back(cells_[y*width_ + x].ch);
+
+	return text;
+}
+
+unsigned long
+ui::buffer_target::refresh_count() const
+{
+	return refresh_count_;
+}
+
+void
+ui::buffer_target::set_size(std::pair<unsigned, unsigned> size)
+{
+	std::tie(width_, height_) = size;
+	cells_.assign(width_*height_, cell{L' ', 0});
+}
+
+void
+ui::buffer_target::clear_screen()
+{
+	std::fill(cells_.begin(), cells_.end(), cell{L' ', 0});
+}
+
+std::unique_ptr<ui::surface>
+ui::buffer_target::create_surface(std::pair<unsigned, unsigned> from,
+				  std::pair<unsigned, unsigned> to)
+{
+	return std::make_unique<buffer_surface>(this, from, to);
+}
+
+std::pair<unsigned, unsigned>
+ui::buffer_target::resize()
+{
+	return size();
+}
+
+std::pair<unsigned, unsigned>
+ui::buffer_target::size() const
+{
+	return std::pair{width_, height_};
+}
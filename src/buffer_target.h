@@ -0,0 +1,84 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "render_target.h"
+
+namespace ui {
+/* buffer_target class
+ * This class implements an offscreen render target that draws into an
+ * in-memory grid of cells. It can be used to render the views without a
+ * terminal, e.g. in tests and benchmarks.
+ */
+class buffer_target : public render_target {
+public:
+	/* cell struct
+	 * This struct represents a single character on the grid
+	 *
+	 * @ch: the character
+	 * @attrs: the effects used when the character was drawn
+	 */
+	struct cell {
+		wchar_t ch;
+		unsigned attrs;
+	};
+
+	/* buffer_target - ctor
+	 * @size: pair containing the width and height of the grid
+	 */
+	buffer_target(std::pair<unsigned, unsigned> size);
+	/* buffer_target - explicitly deleted copy ctor */
+	buffer_target(const buffer_target& rhs) = delete;
+
+	/* ~buffer_target - explicitly defaulted dtor */
+	~buffer_target() = default;
+
+	/* at - get a cell
+	 * @x: x position
+	 * @y: y position
+	 *
+	 * Returns a reference to the cell. Throws std::out_of_range if the
+	 * position is outside of the grid.
+	 */
+	const cell& at(unsigned x, unsigned y) const;
+	/* line - get the text of a line
+	 * @y: y position
+	 *
+	 * Returns the characters of the line as a string. Throws
+	 * std::out_of_range if the line is outside of the grid.
+	 */
+	std::wstring line(unsigned y) const;
+	/* refresh_count - get the number of refreshes
+	 *
+	 * Returns how many times a surface of this target has been refreshed
+	 */
+	unsigned long refresh_count() const;
+	/* set_size - change the size of the grid
+	 * @size: pair containing the new width and height
+	 *
+	 * The contents of the grid are cleared. The change is reported by the
+	 * next call to resize().
+	 */
+	void set_size(std::pair<unsigned, unsigned> size);
+
+	/* implemented from render_target */
+	void clear_screen() override;
+	std::unique_ptr<surface>
+	create_surface(std::pair<unsigned, unsigned> from,
+		       std::pair<unsigned, unsigned> to) override;
+	std::pair<unsigned, unsigned> resize() override;
+	std::pair<unsigned, unsigned> size() const override;
+
+protected:
+	friend class buffer_surface;
+
+	std::vector<cell> cells_;
+	unsigned height_;
+	unsigned long refresh_count_;
+	unsigned width_;
+};
+}
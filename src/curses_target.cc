@@ -0,0 +1,161 @@
+#include "curses_target.h"
+
+#include <array>
+#include <climits>
+#include <clocale>
+#include <cstdlib>
+#include <stdexcept>
+#include <string>
+
+#include <sys/ioctl.h>
+#include <unistd.h>
+
+ui::curses_surface::curses_surface(WINDOW* win) :
+	win_{win}
+{}
+
+ui::curses_surface::~curses_surface()
+{
+	delwin(win_);
+}
+
+void
+ui::curses_surface::effect_off(unsigned attrs)
+{
+	wattroff(win_, attrs);
+}
+
+void
+ui::curses_surface::effect_on(unsigned attrs)
+{
+	wattron(win_, attrs);
+}
+
+void
+ui::curses_surface::draw_border()
+{
+	box(win_, 0, 0);
+}
+
+void
+ui::curses_surface::clear_area()
+{
+	werase(win_);
+}
+
+void
+ui::curses_surface::print(unsigned x, unsigned y, std::wstring_view text)
+{
+	int local_x = x;
+
+	// Every wide character is converted to the multibyte representation
+	// of the current locale and printed in its own column. Should the
+	// conversion fail a std::runtime_error is thrown
+	for (const auto c : text) {
+		if (c == L'\0')
+			break;
+
+		std::array<char, MB_LEN_MAX + 1> temp;
+		temp.fill('\0');
+
+		const int ret = std::wctomb(&temp[0], c);
+		if (ret < 0)
+			throw std::runtime_error{"conversion from wchar_t to char failed"};
+
+		if (ret > 0) {
+			mvwaddstr(win_, y, local_x, &temp[0]);
+			local_x++;
+		}
+	}
+}
+
+void
+ui::curses_surface::print(unsigned x, unsigned y, std::string_view text)
+{
+	mvwaddnstr(win_, y, x, text.data(), text.length());
+}
+
+void
+ui::curses_surface::update()
+{
+	wrefresh(win_);
+}
+
+std::unique_ptr<ui::surface>
+ui::curses_surface::subsurface(std::pair<unsigned, unsigned> from,
+			       std::pair<unsigned, unsigned> to)
+{
+	WINDOW* win = derwin(win_,
+			     std::get<1>(to) - std::get<1>(from),
+			     std::get<0>(to) - std::get<0>(from),
+			     std::get<1>(from),
+			     std::get<0>(from));
+
+	return std::make_unique<curses_surface>(win);
+}
+
+void
+ui::curses_surface::touch()
+{
+	touchwin(win_);
+}
+
+ui::curses_target::curses_target()
+{
+	setlocale(LC_ALL, "");
+	initscr();
+	// Do not capture special key combinations
+	nocbreak();
+	// Do not echo inputs
+	noecho();
+	// Do not render cursor
+	curs_set(0);
+}
+
+ui::curses_target::~curses_target()
+{
+	endwin();
+}
+
+void
+ui::curses_target::clear_screen()
+{
+	erase();
+}
+
+std::unique_ptr<ui::surface>
+ui::curses_target::create_surface(std::pair<unsigned, unsigned> from,
+				  std::pair<unsigned, unsigned> to)
+{
+	WINDOW* win = newwin(std::get<1>(to) - std::get<1>(from),
+			     std::get<0>(to) - std::get<0>(from),
+			     std::get<1>(from),
+			     std::get<0>(from));
+
+	return std::make_unique<curses_surface>(win);
+}
+
+std::pair<unsigned, unsigned>
+ui::curses_target::resize()
+{
+	winsize size;
+
+	// Curses only knows about the new size after it has been told about it
+	if (ioctl(STDOUT_FILENO, TIOCGWINSZ, &size) == 0)
+		resize_term(size.ws_row, size.ws_col);
+
+	wclear(stdscr);
+	wrefresh(stdscr);
+
+	return this->size();
+}
+
+std::pair<unsigned, unsigned>
+ui::curses_target::size() const
+{
+	unsigned width, height;
+
+	getmaxyx(stdscr, height, width);
+
+	return std::pair{width, height};
+}
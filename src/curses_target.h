@@ -0,0 +1,74 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <utility>
+
+#include <curses.h>
+
+#include "render_target.h"
+
+namespace ui {
+/* curses_surface class
+ * This class implements a surface using a ncurses window
+ */
+class curses_surface : public surface {
+public:
+	/* curses_surface - ctor
+	 * @win: the ncurses window, owned by the surface from now on
+	 */
+	curses_surface(WINDOW* win);
+	/* curses_surface - explicitly deleted copy ctor */
+	curses_surface(const curses_surface& rhs) = delete;
+
+	/* ~curses_surface - dtor
+	 *
+	 * This function frees the ncurses window
+	 */
+	~curses_surface();
+
+	/* implemented from surface */
+	void clear_area() override;
+	void draw_border() override;
+	void effect_off(unsigned attrs) override;
+	void effect_on(unsigned attrs) override;
+	void print(unsigned x, unsigned y, std::wstring_view text) override;
+	void print(unsigned x, unsigned y, std::string_view text) override;
+	std::unique_ptr<surface>
+	subsurface(std::pair<unsigned, unsigned> from,
+		   std::pair<unsigned, unsigned> to) override;
+	void touch() override;
+	void update() override;
+
+protected:
+	WINDOW* win_;
+};
+
+/* curses_target class
+ * This class implements a render target drawing on the terminal with ncursesw
+ */
+class curses_target : public render_target {
+public:
+	/* curses_target - ctor
+	 *
+	 * This ctor inits the curses library and sets it up for drawing
+	 */
+	curses_target();
+	/* curses_target - explicitly deleted copy ctor */
+	curses_target(const curses_target& rhs) = delete;
+
+	/* ~curses_target - dtor
+	 *
+	 * This function frees the resources used by curses
+	 */
+	~curses_target();
+
+	/* implemented from render_target */
+	void clear_screen() override;
+	std::unique_ptr<surface>
+	create_surface(std::pair<unsigned, unsigned> from,
+		       std::pair<unsigned, unsigned> to) override;
+	std::pair<unsigned, unsigned> resize() override;
+	std::pair<unsigned, unsigned> size() const override;
+};
+}
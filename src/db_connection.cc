@@ -1,18 +1,200 @@
 #include "db_connection.h"
 
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cstdio>
+#include <ctime>
+#include <exception>
+#include <fstream>
+#include <mutex>
 #include <stdexcept>
+#include <utility>
+
+#include <unistd.h>
 
 #include <curl/curl.h>
 
+/* default_connect_timeout - default connect timeout in seconds */
+constexpr long default_connect_timeout = 10;
+/* default_low_speed_limit - default lowest transfer speed in bytes per second */
+constexpr long default_low_speed_limit = 1;
+/* default_low_speed_time - default time in seconds a transfer may be slow */
+constexpr long default_low_speed_time = 30;
+/* default_timeout - default transfer timeout in seconds */
+constexpr long default_timeout = 60;
+/* max_presize - largest Content-Length trusted when sizing a body, 8 MiB */
+constexpr curl_off_t max_presize = 8 << 20;
+/* max_redirects - the number of redirects followed */
+constexpr long max_redirects = 5;
+/* request_timeout - status reported for cancelled and timed out requests */
+constexpr long request_timeout = 408;
+
+/* cancelled - set when every transfer should be aborted */
+static std::atomic<bool> cancelled{false};
+
+/* cache_magic - first line of a response cache file */
+constexpr char cache_magic[] = "info-tv response 1";
+
+/* cache_entry struct
+ * This struct holds a cached response
+ *
+ * @request: the request the response belongs to
+ * @etag: value of the ETag header
+ * @last_modified: value of the Last-Modified header
+ * @fetch_time: time the response was fetched in seconds since the epoch
+ * @hash: hash of the body
+ * @body: the response body
+ */
+struct cache_entry {
+	std::string request;
+	std::string etag;
+	std::string last_modified;
+	long long fetch_time;
+	std::uint64_t hash;
+	std::string body;
+};
+
+/* shared_state struct
+ * This struct holds the curl state shared by every connection. Curl is
+ * initialized when the first connection is created and cleaned up at exit.
+ *
+ * @share: share handle for the DNS cache, TLS sessions and connections
+ * @locks: a mutex for each kind of shared data
+ */
+struct shared_state {
+	shared_state();
+	shared_state(const shared_state& rhs) = delete;
+	~shared_state();
+
+	CURLSH* share;
+	std::mutex locks[CURL_LOCK_DATA_LAST];
+};
+
+/* transfer struct
+ * This struct holds the state of a single transfer
+ *
+ * @handle: the curl handle performing the transfer
+ * @body: string collecting the body
+ * @started: whether the first chunk has been received
+ * @hash: FNV-1a hash of the bytes received so far
+ * @error: exception thrown while collecting the body
+ */
+struct transfer {
+	CURL* handle;
+	std::string* body;
+	bool started;
+	std::uint64_t hash;
+	std::exception_ptr error;
+};
+
+/* validators struct
+ * This struct collects the cache validators sent with a response
+ *
+ * @etag: value of the ETag header
+ * @last_modified: value of the Last-Modified header
+ */
+struct validators {
+	std::string etag;
+	std::string last_modified;
+};
+
+/* fnv_offset_basis - initial value of an FNV-1a hash */
+constexpr std::uint64_t fnv_offset_basis = 0xcbf29ce484222325;
+
+/* cache_path - get the path of a cache file
+ * @dir: the cache directory
+ * @request: the request string
+ *
+ * Returns a path inside dir with a file name derived from the request
+ */
+static std::string cache_path(const std::string& dir, const std::string& request);
+/* check_status - classify the status of a response
+ * @t: the finished transfer
+ * @status: the HTTP status code, 0 for protocols without one
+ *
+ * Throws http_error unless the status indicates success
+ */
+static void check_status(const transfer& t, long status);
+/* fnv1a - compute the 64-bit FNV-1a hash of a string
+ * @str: the string to hash
+ * @hash: hash of the preceding data, used to hash data in parts
+ */
+static std::uint64_t fnv1a(std::string_view str,
+			   std::uint64_t hash = fnv_offset_basis);
+/* header_callback - collects the validators from the response headers
+ * @buffer: pointer to a single header line, not null terminated
+ * @size: always 1
+ * @count: number of bytes in buffer
+ * @client_data: pointer to a validators struct
+ *
+ * Returns the number of handled bytes
+ */
+static size_t header_callback(char* buffer,
+			      size_t size,
+			      size_t count,
+			      void* client_data);
+/* lock_callback - locks shared data for curl */
+static void lock_callback(CURL* handle,
+			  curl_lock_data data,
+			  curl_lock_access access,
+			  void* client_data);
+/* perform - perform a transfer
+ * @t: the transfer with handle and body set
+ *
+ * Returns the HTTP status code of the response. Throws the exception thrown
+ * while collecting the body, if any, http_error with status 408 if the
+ * transfer was cancelled or timed out, or std::runtime_error if it failed
+ * otherwise.
+ */
+static long perform(transfer& t);
+/* progress_callback - aborts the transfer once cancel_all() is called
+ *
+ * Returns non-zero to abort the transfer
+ */
+static int progress_callback(void* client_data,
+			     curl_off_t download_total,
+			     curl_off_t download_now,
+			     curl_off_t upload_total,
+			     curl_off_t upload_now);
+/* read_cache - read a cache file
+ * @path: path to the cache file
+ * @request: the request the entry has to belong to
+ * @entry: the entry to fill
+ *
+ * Returns true if the file exists, is valid and belongs to request
+ */
+static bool read_cache(const std::string& path,
+		       const std::string& request,
+		       cache_entry& entry);
+/* shared - get the shared curl state
+ *
+ * Returns a reference to the state, creating it on the first call
+ */
+static shared_state& shared();
+/* unlock_callback - unlocks shared data for curl */
+static void unlock_callback(CURL* handle, curl_lock_data data, void* client_data);
+/* write_cache - write a cache file
+ * @path: path to the cache file
+ * @entry: the entry to store
+ *
+ * The entry is written to a temporary file which then replaces the old one.
+ * Throws std::runtime_error if the file can't be written.
+ */
+static void write_cache(const std::string& path, const cache_entry& entry);
+
 /* curl_callback - handels the response from the http request
  * @contents: pointer to a buffer containing the request data
  * @size: always 1
  * @count: number of bytes in contents
- * @client_data: pointer to the client data
+ * @client_data: pointer to the transfer struct
  *
  * Returns the number of handled bytes
  *
- * This function stores the data from curl into an string provided by the client
+ * This function passes the data from curl to the string of the transfer.
+ * Before the first chunk the body is sized from the Content-Length header so
+ * that it doesn't have to grow one chunk at a time. The header isn't trusted
+ * beyond max_presize bytes.
  *
  * This function can be called multiple timer for a single http request
  */
@@ -21,35 +203,173 @@ static size_t curl_callback(char* contents,
 			    size_t count,
 			    void* client_data)
 {
-	std::string* response = reinterpret_cast<std::string*>(client_data);
+	transfer* t = reinterpret_cast<transfer*>(client_data);
+	const std::string_view chunk{contents, size*count};
+
+	try {
+		if (not t->started) {
+			t->started = true;
+
+			curl_off_t length = -1;
+			curl_easy_getinfo(t->handle,
+					  CURLINFO_CONTENT_LENGTH_DOWNLOAD_T,
+					  &length);
+
+			if (length > 0)
+				t->body->reserve(std::min(length, max_presize));
+		}
+
+		t->body->append(chunk);
+	} catch (...) {
+		// Returning less than was given makes curl abort the transfer
+		t->error = std::current_exception();
+		return 0;
+	}
 
-	response->append(contents, size*count);
+	t->hash = fnv1a(chunk, t->hash);
 
 	return size*count;
 }
 
-events::db_connection::db_connection()
+events::http_error::http_error(long status,
+			       unsigned long retry_after,
+			       std::string body) :
+	std::runtime_error{"server responded with status " + std::to_string(status)},
+	body_{std::move(body)},
+	retry_after_{retry_after},
+	status_{status}
+{}
+
+std::string_view
+events::http_error::body() const
+{
+	return std::string_view{body_};
+}
+
+unsigned long
+events::http_error::retry_after() const
+{
+	return retry_after_;
+}
+
+long
+events::http_error::status() const
+{
+	return status_;
+}
+
+bool
+events::http_error::temporary() const
+{
+	return status_ == 408 or status_ == 429 or (status_ >= 500 and status_ < 600);
+}
+
+events::db_connection::db_connection() :
+	content_hash_{0}
 {
 	setup_curl();
 }
 
+events::db_connection::~db_connection()
+{
+	curl_easy_cleanup(handle_);
+}
+
+void
+events::db_connection::cancel_all()
+{
+	cancelled = true;
+}
+
 std::string
 events::db_connection::get_response()
 {
 	if (request_.empty())
 		throw std::logic_error{"no request set"};
 
+	cache_entry cached;
+	const bool have_cache = not cache_dir_.empty() and
+				read_cache(cache_path(cache_dir_, request_),
+					   request_,
+					   cached);
+
+	// Ask the server to only send the body if it differs from the cached one
+	curl_slist* headers = nullptr;
+
+	if (have_cache and not cached.etag.empty())
+		headers = curl_slist_append(headers,
+					    ("If-None-Match: " + cached.etag).c_str());
+	if (have_cache and not cached.last_modified.empty())
+		headers = curl_slist_append(headers,
+					    ("If-Modified-Since: " + cached.last_modified).c_str());
+
 	std::string response_str;
+	validators received;
+	transfer t{handle_, &response_str, false, fnv_offset_basis, nullptr};
+
+	curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, headers);
+	curl_easy_setopt(handle_, CURLOPT_HEADERDATA, &received);
+	long status;
+
+	try {
+		status = perform(t);
+	} catch (...) {
+		curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, nullptr);
+		curl_slist_free_all(headers);
+		throw;
+	}
 
-	curl_easy_setopt(handle_, CURLOPT_WRITEDATA, &response_str);
-	curl_easy_perform(handle_);
+	curl_easy_setopt(handle_, CURLOPT_HTTPHEADER, nullptr);
+	curl_slist_free_all(headers);
+
+	if (have_cache and status == 304) {
+		content_hash_ = cached.hash;
+		return std::move(cached.body);
+	}
+
+	check_status(t, status);
 
 	if (response_str.empty())
 		throw std::runtime_error{"empty response"};
-	
+
+	content_hash_ = t.hash;
+
+	if (not cache_dir_.empty()) {
+		// A failure to cache the response only costs a full download
+		try {
+			write_cache(cache_path(cache_dir_, request_),
+				    cache_entry{request_,
+						received.etag,
+						received.last_modified,
+						static_cast<long long>(std::time(nullptr)),
+						content_hash_,
+						response_str});
+		} catch (...) {
+		}
+	}
+
 	return response_str;
 }
 
+void
+events::db_connection::set_cache_dir(const std::string& dir)
+{
+	cache_dir_ = dir;
+}
+
+void
+events::db_connection::set_connect_timeout(unsigned long secs)
+{
+	curl_easy_setopt(handle_, CURLOPT_CONNECTTIMEOUT, long(secs));
+}
+
+void
+events::db_connection::set_low_speed_limit(unsigned long bytes, unsigned long secs)
+{
+	curl_easy_setopt(handle_, CURLOPT_LOW_SPEED_LIMIT, long(bytes));
+	curl_easy_setopt(handle_, CURLOPT_LOW_SPEED_TIME, long(secs));
+}
+
 void
 events::db_connection::set_request(const std::string& request)
 {
@@ -57,22 +377,55 @@ events::db_connection::set_request(const std::string& request)
 	setup_curl_request();
 }
 
+void
+events::db_connection::set_timeout(unsigned long secs)
+{
+	curl_easy_setopt(handle_, CURLOPT_TIMEOUT, long(secs));
+}
+
 std::string_view
 events::db_connection::request() const
 {
 	return std::string_view(request_);
 }
 
+std::uint64_t
+events::db_connection::content_hash() const
+{
+	return content_hash_;
+}
+
 /* setup_curl - helper function for setting up curl */
 void
 events::db_connection::setup_curl()
 {
-	curl_global_init(CURL_GLOBAL_ALL);
+	CURLSH* share = shared().share;
 
 	handle_ = curl_easy_init();
 
+	if (handle_ == nullptr)
+		throw std::runtime_error{"failed to create a curl handle"};
+
+	curl_easy_setopt(handle_, CURLOPT_SHARE, share);
+
 	curl_easy_setopt(handle_, CURLOPT_VERBOSE, 0L);
 	curl_easy_setopt(handle_, CURLOPT_WRITEFUNCTION, curl_callback);
+	curl_easy_setopt(handle_, CURLOPT_HEADERFUNCTION, header_callback);
+	// An empty string offers every encoding curl was built with, which
+	// includes gzip, deflate and brotli where available
+	curl_easy_setopt(handle_, CURLOPT_ACCEPT_ENCODING, "");
+	curl_easy_setopt(handle_, CURLOPT_FOLLOWLOCATION, 1L);
+	curl_easy_setopt(handle_, CURLOPT_MAXREDIRS, max_redirects);
+
+	// Signals are left to the program, the progress callback is used to
+	// cancel transfers and the timeouts keep a hung server from blocking
+	curl_easy_setopt(handle_, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt(handle_, CURLOPT_NOPROGRESS, 0L);
+	curl_easy_setopt(handle_, CURLOPT_XFERINFOFUNCTION, progress_callback);
+	curl_easy_setopt(handle_, CURLOPT_CONNECTTIMEOUT, default_connect_timeout);
+	curl_easy_setopt(handle_, CURLOPT_TIMEOUT, default_timeout);
+	curl_easy_setopt(handle_, CURLOPT_LOW_SPEED_LIMIT, default_low_speed_limit);
+	curl_easy_setopt(handle_, CURLOPT_LOW_SPEED_TIME, default_low_speed_time);
 }
 
 /* setup_curl_request - helper function for setting the request string*/
@@ -81,3 +434,220 @@ events::db_connection::setup_curl_request()
 {
 	curl_easy_setopt(handle_, CURLOPT_URL, request_.c_str());
 }
+
+shared_state::shared_state()
+{
+	curl_global_init(CURL_GLOBAL_ALL);
+
+	share = curl_share_init();
+
+	curl_share_setopt(share, CURLSHOPT_LOCKFUNC, lock_callback);
+	curl_share_setopt(share, CURLSHOPT_UNLOCKFUNC, unlock_callback);
+	curl_share_setopt(share, CURLSHOPT_USERDATA, this);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	curl_share_setopt(share, CURLSHOPT_SHARE, CURL_LOCK_DATA_CONNECT);
+}
+
+shared_state::~shared_state()
+{
+	curl_share_cleanup(share);
+	curl_global_cleanup();
+}
+
+static std::string
+cache_path(const std::string& dir, const std::string& request)
+{
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.resp",
+		      static_cast<unsigned long long>(fnv1a(request)));
+
+	return dir + '/' + name;
+}
+
+static void
+check_status(const transfer& t, long status)
+{
+	// Protocols other than HTTP, e.g. file://, have no status
+	if (status == 0 or (status >= 200 and status < 300))
+		return;
+
+	// Curl parses both forms of Retry-After into seconds
+	curl_off_t retry_after = 0;
+	curl_easy_getinfo(t.handle, CURLINFO_RETRY_AFTER, &retry_after);
+
+	throw events::http_error{status,
+				 static_cast<unsigned long>(std::max<curl_off_t>(retry_after, 0)),
+				 *t.body};
+}
+
+static std::uint64_t
+fnv1a(std::string_view str, std::uint64_t hash)
+{
+	for (const unsigned char c : str) {
+		hash ^= c;
+		hash *= 0x100000001b3;
+	}
+
+	return hash;
+}
+
+static size_t
+header_callback(char* buffer, size_t size, size_t count, void* client_data)
+{
+	validators* received = reinterpret_cast<validators*>(client_data);
+	const std::string_view line{buffer, size*count};
+
+	// A new status line starts the headers of a redirected response
+	if (line.compare(0, 5, "HTTP/") == 0) {
+		*received = validators{};
+		return size*count;
+	}
+
+	const auto colon = line.find(':');
+	if (colon == std::string_view::npos)
+		return size*count;
+
+	std::string name;
+	for (const char c : line.substr(0, colon))
+		name += std::tolower(static_cast<unsigned char>(c));
+
+	auto value = line.substr(colon + 1);
+	while (not value.empty() and std::isspace(static_cast<unsigned char>(value.front())))
+		value.remove_prefix(1);
+	while (not value.empty() and std::isspace(static_cast<unsigned char>(value.back())))
+		value.remove_suffix(1);
+
+	if (name == "etag")
+		received->etag = value;
+	else if (name == "last-modified")
+		received->last_modified = value;
+
+	return size*count;
+}
+
+static void
+lock_callback(CURL* /*handle*/,
+	      curl_lock_data data,
+	      curl_lock_access /*access*/,
+	      void* client_data)
+{
+	reinterpret_cast<shared_state*>(client_data)->locks[data].lock();
+}
+
+static long
+perform(transfer& t)
+{
+	// A cancelled or timed out request is reported like a Request Timeout
+	// from the server, so that the callers retry it the same way
+	if (cancelled)
+		throw events::http_error{request_timeout};
+
+	curl_easy_setopt(t.handle, CURLOPT_WRITEDATA, &t);
+	const CURLcode result = curl_easy_perform(t.handle);
+
+	if (t.error)
+		std::rethrow_exception(t.error);
+
+	if (result == CURLE_ABORTED_BY_CALLBACK or result == CURLE_OPERATION_TIMEDOUT)
+		throw events::http_error{request_timeout};
+	if (result != CURLE_OK)
+		throw std::runtime_error{curl_easy_strerror(result)};
+
+	long status = 0;
+	curl_easy_getinfo(t.handle, CURLINFO_RESPONSE_CODE, &status);
+
+	return status;
+}
+
+static int
+progress_callback(void* /*client_data*/,
+		  curl_off_t /*download_total*/,
+		  curl_off_t /*download_now*/,
+		  curl_off_t /*upload_total*/,
+		  curl_off_t /*upload_now*/)
+{
+	return cancelled ? 1 : 0;
+}
+
+static bool
+read_cache(const std::string& path, const std::string& request, cache_entry& entry)
+{
+	std::ifstream in{path, std::ios::in | std::ios::binary};
+	std::string magic;
+	std::string fetch_time;
+	std::string hash;
+	std::string body_size;
+
+	if (not std::getline(in, magic) or magic != cache_magic)
+		return false;
+
+	if (not std::getline(in, entry.request) or entry.request != request)
+		return false;
+
+	if (not std::getline(in, entry.etag) or
+	    not std::getline(in, entry.last_modified) or
+	    not std::getline(in, fetch_time) or
+	    not std::getline(in, hash) or
+	    not std::getline(in, body_size))
+		return false;
+
+	try {
+		entry.fetch_time = std::stoll(fetch_time);
+		entry.hash = std::stoull(hash, nullptr, 16);
+		entry.body.resize(std::stoull(body_size));
+	} catch (...) {
+		return false;
+	}
+
+	in.read(entry.body.data(), entry.body.size());
+
+	return bool(in) and fnv1a(entry.body) == entry.hash;
+}
+
+static shared_state&
+shared()
+{
+	static shared_state state;
+
+	return state;
+}
+
+static void
+unlock_callback(CURL* /*handle*/, curl_lock_data data, void* client_data)
+{
+	reinterpret_cast<shared_state*>(client_data)->locks[data].unlock();
+}
+
+static void
+write_cache(const std::string& path, const cache_entry& entry)
+{
+	const std::string temp_path = path + ".tmp." + std::to_string(getpid());
+
+	{
+		std::ofstream out{temp_path, std::ios::out | std::ios::binary | std::ios::trunc};
+		char hash[17];
+
+		std::snprintf(hash, sizeof(hash), "%016llx",
+			      static_cast<unsigned long long>(entry.hash));
+
+		out << cache_magic << '\n'
+		    << entry.request << '\n'
+		    << entry.etag << '\n'
+		    << entry.last_modified << '\n'
+		    << entry.fetch_time << '\n'
+		    << hash << '\n'
+		    << entry.body.size() << '\n';
+		out.write(entry.body.data(), entry.body.size());
+
+		if (not out) {
+			std::remove(temp_path.c_str());
+			throw std::runtime_error{"failed to write the response cache"};
+		}
+	}
+
+	if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+		std::remove(temp_path.c_str());
+		throw std::runtime_error{"failed to replace the response cache"};
+	}
+}
@@ -1,14 +1,58 @@
 #pragma once
 
+#include <cstdint>
+#include <stdexcept>
 #include <string>
 #include <string_view>
 
 #include <curl/curl.h>
 
 namespace events {
+/* http_error class
+ * This exception is thrown when the server answers with an error status
+ */
+class http_error : public std::runtime_error {
+public:
+	/* http_error - ctor
+	 * @status: the HTTP status code of the response
+	 * @retry_after: seconds the server asked to wait, 0 if it didn't
+	 * @body: the body of the response
+	 */
+	http_error(long status, unsigned long retry_after = 0, std::string body = {});
+
+	/* body - get the response body
+	 *
+	 * Returns a string view to the body of the error response
+	 */
+	std::string_view body() const;
+	/* retry_after - get the requested delay
+	 *
+	 * Returns the number of seconds given in the Retry-After header of
+	 * the response, or 0 if there was none
+	 */
+	unsigned long retry_after() const;
+	/* status - get the status code
+	 *
+	 * Returns the HTTP status code of the response
+	 */
+	long status() const;
+	/* temporary - check if the error is temporary
+	 *
+	 * Returns true if the same request may succeed later, i.e. on a
+	 * timeout (408), too many requests (429) or a server error (5xx)
+	 */
+	bool temporary() const;
+
+protected:
+	std::string body_;
+	unsigned long retry_after_;
+	long status_;
+};
+
 /* db_connection class
  * This class wraps a curl request instance and handles the connection to
- * the Google API
+ * the Google API. All instances share the DNS cache, TLS sessions and open
+ * connections, so repeated requests to the same host skip the handshakes.
  */
 class db_connection {
 public:
@@ -22,32 +66,93 @@ public:
 	/* db_connection - explicitly deleted copy ctor */
 	db_connection(const db_connection& rhs) = delete;
 
-	/* ~db_connection - explicitly defaulted dtor */
-	~db_connection() = default;
+	/* ~db_connection - dtor
+	 *
+	 * This function frees the curl handle. Shared connections stay open
+	 * for the other connection objects.
+	 */
+	~db_connection();
+
+	/* cancel_all - cancel all requests
+	 *
+	 * Aborts the running requests of every connection and makes further
+	 * requests fail right away with a temporary http_error. The function
+	 * only sets a flag, so it can be called from a signal handler when the
+	 * program is shutting down.
+	 */
+	static void cancel_all();
 
 	/* get_response - perform the request
 	 * 
 	 * Returns a string containing the response. Throws std::logic_error
-	 * if the request was empty or std::runtime_error if the response was
-	 * empty
+	 * if the request was empty, http_error if the server answered with an
+	 * error status or std::runtime_error if the transfer failed or the
+	 * response was empty. A transfer that timed out or was cancelled
+	 * throws http_error with status 408, so it is retried like a Request
+	 * Timeout from the server.
+	 *
+	 * If a cache directory is set and a response to the same request has
+	 * been cached, the request is made conditional on the cached ETag and
+	 * Last-Modified validators. Should the server answer that nothing has
+	 * changed the cached body is returned instead.
+	 *
+	 * The server is offered gzip, deflate and brotli encoded responses.
 	 *
 	 * This call blocks until curl has performed the http reequest!
 	 */
 	std::string get_response();
+	/* set_cache_dir - enable the response cache
+	 * @dir: directory where the responses are stored
+	 *
+	 * Every successful response is stored in dir together with its
+	 * validators, fetch time and content hash. The file name is derived
+	 * from the request, so the cache survives restarts. An empty string
+	 * disables the cache.
+	 */
+	void set_cache_dir(const std::string& dir);
+	/* set_connect_timeout - set the connect timeout
+	 * @secs: seconds allowed for connecting to the server
+	 *
+	 * Defaults to 10 seconds
+	 */
+	void set_connect_timeout(unsigned long secs);
+	/* set_low_speed_limit - abort slow transfers
+	 * @bytes: lowest acceptable speed in bytes per second
+	 * @secs: seconds the transfer may stay below the speed
+	 *
+	 * Defaults to 1 byte per second for 30 seconds so that a stalled
+	 * server is given up on
+	 */
+	void set_low_speed_limit(unsigned long bytes, unsigned long secs);
 	/* set_request - sets the request string
 	 * @request: the string to use as request
 	 *
 	 * The string is used as the url of the http request
 	 */
 	void set_request(const std::string& request);
+	/* set_timeout - set the transfer timeout
+	 * @secs: seconds allowed for the whole request
+	 *
+	 * Defaults to 60 seconds
+	 */
+	void set_timeout(unsigned long secs);
 
 	/* request - returns the request string
 	 *
 	 * Returns a string view  to the string used as the request string
 	 */
 	std::string_view request() const;
+	/* content_hash - get the hash of the last response
+	 *
+	 * Returns a 64-bit hash of the body returned by the last call to
+	 * get_response(). Callers can compare it to skip parsing a body they
+	 * have already seen.
+	 */
+	std::uint64_t content_hash() const;
 
 protected:
+	std::string cache_dir_;
+	std::uint64_t content_hash_;
 	CURL* handle_;
 	std::string request_;
 
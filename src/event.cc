@@ -1,31 +1,42 @@
 #include "event.h"
 
 #include <stdexcept>
+#include <utility>
 
 events::event::event(const std::wstring& name,
-		     const ptime& start_time,
-		     const ptime& end_time) :
-	duration_{start_time, end_time},
+		     util::time_point start_time,
+		     util::time_point end_time) :
+	conflict_{false},
+	end_{end_time},
 	hilight_{false},
-	name_{name}
+	name_{name},
+	source_{0},
+	start_{start_time}
 {
 	if (start_time > end_time)
 		throw std::logic_error{"start time has to be before end"};
 }
 
 void
-events::event::set_description(const std::wstring& description)
+events::event::set_conflict(bool conflict)
 {
-	description_ = description;
+	conflict_ = conflict;
 }
 
 void
-events::event::set_duration(const ptime& start, const ptime& end)
+events::event::set_description(std::string description)
+{
+	description_ = std::move(description);
+}
+
+void
+events::event::set_duration(util::time_point start, util::time_point end)
 {
 	if (start > end)
 		throw std::logic_error{"start time has to be before end"};
 
-	duration_ = time_period{start, end};
+	start_ = start;
+	end_ = end;
 }
 
 void
@@ -52,16 +63,28 @@ events::event::set_name(const std::wstring& name)
 	name_ = name;
 }
 
-std::wstring_view
+void
+events::event::set_source(unsigned source)
+{
+	source_ = source;
+}
+
+bool
+events::event::conflict() const
+{
+	return conflict_;
+}
+
+std::string_view
 events::event::description() const
 {
-	return std::wstring_view{description_};
+	return std::string_view{description_};
 }
 
-time_period
-events::event::duration() const
+util::time_point
+events::event::end() const
 {
-	return duration_;
+	return end_;
 }
 
 bool
@@ -88,3 +111,14 @@ events::event::name() const
 	return std::wstring_view{name_};
 }
 
+unsigned
+events::event::source() const
+{
+	return source_;
+}
+
+util::time_point
+events::event::start() const
+{
+	return start_;
+}
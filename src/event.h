@@ -3,10 +3,7 @@
 #include <string>
 #include <string_view>
 
-#include <boost/date_time.hpp>
-
-using boost::posix_time::ptime;
-using boost::posix_time::time_period;
+#include "local_time.h"
 
 namespace events {
 /* search_target - which parts of the event can be searched when highlighting */
@@ -20,34 +17,40 @@ class event {
 public:
 	/* event - ctor
 	 * @name: name of the event
-	 * @start_time: event start time in boost::posix_time::ptime format
-	 * @end_time: event end time in boost::posix_time::ptime format
+	 * @start_time: event start time
+	 * @end_time: event end time
 	 *
 	 * Throws std::logic_error if start_time > end_time
 	 */
 	event(const std::wstring& name,
-	      const ptime& start_time,
-	      const ptime& end_time);
+	      util::time_point start_time,
+	      util::time_point end_time);
 	/* event - explicitly defaulted copy ctor */
 	event(const event& rhs) = default;
 
 	/* ~event - explicitly defaulted dtor */
 	~event() = default;
 
+	/* set_conflict - mark the event as a room conflict
+	 * @conflict: true if another event is held at the same location at
+	 *            the same time
+	 */
+	void set_conflict(bool conflict);
 	/*set_description - set the event description
-	 * @description: event description
+	 * @description: event description in utf-8
 	 *
-	 * Sets the event description used for highlighting.
+	 * Sets the event description used for highlighting. It is kept as
+	 * utf-8 and only decoded by the rules that search it.
 	 */
-	void set_description(const std::wstring& description);
+	void set_description(std::string description);
 	/* set_duration - set the event duration
-	 * @start: boost::posix_time::ptime representation of the start time
-	 * @end: boost::posix_time::ptime representation of the end time
+	 * @start: the start time
+	 * @end: the end time
 	 *
 	 * Sets the event to span from start to end. Throws std::logica_error if
 	 * start > end
 	 */
-	void set_duration(const ptime& start, const ptime& end);
+	void set_duration(util::time_point start, util::time_point end);
 	/* set_hilight - change event highlighting
 	 * @hilight: event highlighting status
 	 *
@@ -72,18 +75,29 @@ public:
 	 * Sets the event name to be the supplied string
 	 */
 	void set_name(const std::wstring& name);
+	/* set_source - set the event source
+	 * @source: index of the source that provided the event
+	 *
+	 * Sets the index of the event source this event came from
+	 */
+	void set_source(unsigned source);
 
+	/* conflict - check if the event is a room conflict
+	 *
+	 * Returns true if the event overlaps another event at the same location
+	 */
+	bool conflict() const;
 	/* description - get the event description
 	 *
-	 * Returns the event description.
+	 * Returns the event description in utf-8. The bytes are not validated.
 	 */
-	std::wstring_view description() const;
-	/* duration -  get the event duration
+	std::string_view description() const;
+	/* end - get the event end time
 	 *
-	 * Returns a boost::posix_time::time_period object representing the span
-	 * of this event
+	 * Returns the time the event ends. The event doesn't include this
+	 * time.
 	 */
-	time_period duration() const;
+	util::time_point end() const;
 	/* hilight - check if the event is highlighted
 	 *
 	 * Returns true if event is highlighted
@@ -104,13 +118,26 @@ public:
 	 * Return a string view of the event name
 	 */
 	std::wstring_view name() const;
+	/* source - get the event source
+	 *
+	 * Returns the index of the event source this event came from
+	 */
+	unsigned source() const;
+	/* start - get the event start time
+	 *
+	 * Returns the time the event starts
+	 */
+	util::time_point start() const;
 
 protected:
-	std::wstring description_;
-	time_period duration_;
+	bool conflict_;
+	std::string description_;
+	util::time_point end_;
 	bool hilight_;
 	std::string id_;
 	std::wstring location_;
 	std::wstring name_;
+	unsigned source_;
+	util::time_point start_;
 };
 }
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <list>
 #include <optional>
 #include <regex>
@@ -28,6 +29,17 @@ public:
 	 * value. This can be used to schedule a retry after an failed update.
 	 */
 	virtual void lower_cooldown() = 0;
+	/* restore - offer the events of an earlier run
+	 * @events: events the backend provided before
+	 * @hash: content_hash() of the backend when it provided them
+	 *
+	 * A backend that skips parsing unchanged data can return these events
+	 * when it receives data with the same hash instead of parsing it. The
+	 * default implementation ignores them.
+	 */
+	virtual void restore(const std::list<event>& /*events*/,
+			     std::uint64_t /*hash*/)
+	{}
 	/* update - try to get new events from the backend
 	 *
 	 * Returns an optional containing a list of the events provided by
@@ -42,5 +54,14 @@ public:
 	 * otherwise
 	 */
 	virtual bool ready() const = 0;
+	/* content_hash - get the hash of the data of the last events
+	 *
+	 * Returns the hash of the data the events last returned by update()
+	 * were parsed from, or 0 if the backend doesn't keep one
+	 */
+	virtual std::uint64_t content_hash() const
+	{
+		return 0;
+	}
 };
 }
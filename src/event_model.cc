@@ -4,17 +4,26 @@
 #include <iterator>
 #include <optional>
 #include <sstream>
+#include <stdexcept>
 
-#include <boost/date_time.hpp>
-
-using boost::posix_time::second_clock;
+#include "unicode.h"
 
 static bool add_events(std::list<events::event>& dst,
+		       util::interval_tree<events::event*>& index,
 		       const std::list<events::event>& src,
 	   	       const std::vector<std::pair<events::search_target, std::basic_regex<wchar_t>>>& rules);
 static bool do_regex_search(const std::pair<events::search_target, std::basic_regex<wchar_t>>& rule,
 			    const events::event& event);
 static void combine_with(events::event& lhs, const events::event& rhs);
+static void find_conflicts(std::list<events::event>& events,
+			   const util::interval_tree<events::event*>& index);
+
+events::event_model::event_model() :
+	conflict_hilight_{false},
+	keep_descriptions_{false},
+	revision_{0},
+	source_count_{0}
+{}
 
 void
 events::event_model::add_hilight(unsigned source)
@@ -29,10 +38,31 @@ events::event_model::add_hilight(std::basic_regex<wchar_t> rule,
 	regex_rules_.emplace_back(std::pair(target, std::move(rule)));
 }
 
+void
+events::event_model::set_conflict_hilight(bool enabled)
+{
+	conflict_hilight_ = enabled;
+}
+
+void
+events::event_model::set_keep_descriptions(bool enabled)
+{
+	keep_descriptions_ = enabled;
+}
+
 void
 events::event_model::add_source(std::shared_ptr<event_backend_interface> source)
 {
-	event_sources_.push_back(std::pair(source, std::list<event>{}));
+	const unsigned index = source_count_++;
+
+	for (auto& existing : event_sources_) {
+		if (existing.backend == source) {
+			existing.indices.push_back(index);
+			return;
+		}
+	}
+
+	event_sources_.push_back({source, std::list<event>{}, {index}});
 }
 
 bool
@@ -40,131 +70,195 @@ events::event_model::update()
 {
 	bool new_events = false;
 
-	for (auto& [source, source_events] : event_sources_) {
-		if (source->ready()) {
-			auto result = source->update();
+	// The descriptions are not shown, so they are only kept if the events
+	// are exported or a rule searches them
+	const bool keep_descriptions = keep_descriptions_ or
+				       std::any_of(regex_rules_.begin(),
+						   regex_rules_.end(),
+						   [](const auto& rule) {
+		return (rule.first & events::search_target::description) != 0;
+	});
+
+	for (auto& source : event_sources_) {
+		if (source.backend->ready()) {
+			auto result = source.backend->update();
 
 			if (result.has_value()) {
 				new_events = true;
-				source_events = result.value();
+				source.events = std::move(result.value());
+
+				if (not keep_descriptions)
+					for (auto& event : source.events)
+						event.set_description({});
 			} else {
-				source->lower_cooldown();
+				source.backend->lower_cooldown();
 				continue;
 			}
 		}
 	}
 
 	// If any of the sources provided updates we need to rebuild our local
-	// events list. Otherwise we can just remove passed events
+	// events list from scratch
 	if (new_events) {
-		unsigned i = 0;
-		for (auto& [source, source_events] : event_sources_) {
-			if (source_rules_.find(i) != source_rules_.end())
-				for (auto& event : source_events)
+		events_.clear();
+		index_.clear();
+
+		for (auto& source : event_sources_) {
+			// A backend added more than once is highlighted if any
+			// of its indices is
+			const bool hilight = std::any_of(source.indices.begin(),
+							 source.indices.end(),
+							 [this](unsigned i) {
+				return source_rules_.find(i) != source_rules_.end();
+			});
+
+			for (auto& event : source.events) {
+				event.set_source(source.indices.front());
+
+				if (hilight)
 					event.set_hilight(true);
+			}
 
-			add_events(events_, source_events, regex_rules_);
-
-			i++;
+			add_events(events_, index_, source.events, regex_rules_);
 		}
-	} else {
-		events_.remove_if([](const events::event& e) {
-			return e.duration().end() <
-			       second_clock::local_time();
+
+		// The events were added in the order of their sources. The
+		// sort is stable so the earlier source comes first if two
+		// events start at the same time.
+		events_.sort([](const events::event& a, const events::event& b) {
+			return a.start() < b.start();
 		});
+
+		if (conflict_hilight_)
+			find_conflicts(events_, index_);
 	}
 
+	// Sources can provide events that have already ended, e.g. from an old
+	// snapshot, so the passed events are removed in both cases
+	const auto now = util::now();
+	const auto size = events_.size();
+
+	events_.remove_if([this, &now](events::event& e) {
+		if (e.end() >= now)
+			return false;
+
+		index_.erase(e.start(), &e);
+
+		return true;
+	});
+
+	if (new_events or events_.size() != size)
+		revision_++;
+
 	return new_events;
 }
 
-std::list<events::event>
+const std::list<events::event>&
 events::event_model::events() const
 {
 	return events_;
 }
 
-/* event_comparison structure
- * This structure represents a comparison between one to multiple events.
- * It can be used to see if the lhs event, stored inside the struct, is equal
- * to any other event or if any other event start after the lhs event.
- */
-struct event_comparison {
-	event_comparison(const events::event& lhs) :
-		is_same_{false},
-		lhs_{lhs}
-	{};
-
-	/* operator() - compares the lhs and rhs events
-	 * @rhs: the event to compare to the lhs event
-	 *
-	 * Returns true if the events are (probably) the same or
-	 * if the rhs event starts after the lhs event.
-	 *
-	 * Events are considered to be the same if their names match.
-	 */
-	bool
-	operator()(const events::event& rhs)
-	{
-		if (lhs_.name() == rhs.name() and
-		    lhs_.duration().intersects(rhs.duration())) {
-			is_same_ = true;
-			return true;
-		} else {
-			is_same_ = false;
-			return (lhs_.duration().begin() <
-				rhs.duration().begin());
-		}
-	}
+std::vector<const events::event*>
+events::event_model::in_progress(util::time_point time) const
+{
+	return overlapping(time, time + std::chrono::seconds(1));
+}
 
-	bool
-	was_equal() const
-	{
-		return is_same_;
-	}
+std::vector<const events::event*>
+events::event_model::overlapping(util::time_point begin,
+				 util::time_point end) const
+{
+	std::vector<const event*> result;
+
+	index_.overlapping(begin, end, [&result](util::time_point,
+						 util::time_point,
+						 const event* e) {
+		result.push_back(e);
+		return true;
+	});
+
+	return result;
+}
+
+std::vector<const events::event*>
+events::event_model::upcoming(util::time_point time,
+			      std::size_t count,
+			      const std::unordered_set<unsigned>& sources) const
+{
+	std::vector<const event*> result;
+
+	if (count == 0)
+		return result;
+
+	index_.overlapping(time, util::time_point::max(), [&](util::time_point,
+								util::time_point,
+								const event* e) {
+		if (sources.empty() or sources.count(e->source()))
+			result.push_back(e);
+
+		return result.size() < count;
+	});
+
+	return result;
+}
 
-private:
-	bool is_same_;
-	const events::event& lhs_;
-};
+unsigned long
+events::event_model::revision() const
+{
+	return revision_;
+}
 
 /* add_events - add new events
  * @dst: destination list
+ * @index: interval tree of the events in dst
  * @src: source list
  * @regexes: a vector of regexes for event highlighting
  *
  * Returns true if new events where added otherwise false.
  *
- * This function adds new events from src to dst list and combines duplicate
- * events. Events that match the any one of the regexes from the vector are
- * hilighted.
+ * This function adds new events from src to the end of dst list and combines
+ * duplicate events. Events are considered to be the same if their names match
+ * and they overlap. Events that match the any one of the regexes from the
+ * vector are hilighted.
  */
 static bool
 add_events(std::list<events::event>& dst,
+	   util::interval_tree<events::event*>& index,
 	   const std::list<events::event>& src,
 	   const std::vector<std::pair<events::search_target, std::basic_regex<wchar_t>>>& rules)
 {
 	bool new_events = false;
 
 	for (auto new_event : src) {
-		// Find the first existing event that starts after the new
-		// event or that is (probably) the same event
-		event_comparison cmp(new_event);
-
-		auto it = find_if(dst.begin(), dst.end(), std::ref(cmp));
-
-		// If the event was equal to an existing event we can skip it
-		// otherwise it is added before the first event that starts after
-		// it. If no existing event start after this event then it is
-		// inserted to the end of the list
-		if (cmp.was_equal()) {
-			combine_with(*it, new_event);
-		} else {
+		// Only the overlapping events are compared, so a long event
+		// isn't compared against every other one
+		events::event* same = nullptr;
+
+		index.overlapping(new_event.start(), new_event.end(),
+				  [&new_event, &same](util::time_point,
+						      util::time_point,
+						      events::event* existing) {
+			if (existing->name() != new_event.name())
+				return true;
+
+			same = existing;
+			return false;
+		});
 
+		if (same) {
+			// The combined event can be longer, so it is added to
+			// the tree again
+			index.erase(same->start(), same);
+			combine_with(*same, new_event);
+			index.insert(same->start(), same->end(), same);
+		} else {
 			for (auto& rule : rules)
 				if (not new_event.hilight())
 					new_event.set_hilight(do_regex_search(rule, new_event));
 
-			dst.insert(it, std::move(new_event));
+			dst.push_back(std::move(new_event));
+			index.insert(dst.back().start(), dst.back().end(), &dst.back());
 			new_events = true;
 		}
 	}
@@ -188,8 +282,15 @@ do_regex_search(const std::pair<events::search_target, std::basic_regex<wchar_t>
 		found |= std::regex_search(event.name().data(), rule.second);
 	}
 
-	if (rule.first & events::search_target::description) {
-		found |= std::regex_search(event.description().data(), rule.second);
+	// The description is decoded only here. One that isn't valid
+	// utf-8 doesn't match.
+	if (rule.first & events::search_target::description and
+	    not found and not event.description().empty()) {
+		try {
+			found |= std::regex_search(util::from_utf8(event.description()),
+						   rule.second);
+		} catch (const std::range_error&) {
+		}
 	}
 	
 	if (rule.first & events::search_target::location) {
@@ -218,9 +319,33 @@ combine_with(events::event& lhs, const events::event& rhs)
 	// be highlighted
 	lhs.set_hilight(lhs.hilight() or rhs.hilight());
 
-	auto duration = lhs.duration().span(rhs.duration());
-	auto start = duration.begin();
-	auto end = duration.end();
+	lhs.set_duration(std::min(lhs.start(), rhs.start()),
+			 std::max(lhs.end(), rhs.end()));
+}
 
-	lhs.set_duration(start, end);
+/* find_conflicts - mark the room conflicts
+ * @events: the events
+ * @index: interval tree of the events
+ *
+ * Marks every event that overlaps another event at the same location.
+ */
+static void
+find_conflicts(std::list<events::event>& events,
+	       const util::interval_tree<events::event*>& index)
+{
+	for (auto& event : events) {
+		if (event.location().empty())
+			continue;
+
+		index.overlapping(event.start(), event.end(),
+				  [&event](util::time_point,
+					   util::time_point,
+					   const events::event* other) {
+			if (other == &event or other->location() != event.location())
+				return true;
+
+			event.set_conflict(true);
+			return false;
+		});
+	}
 }
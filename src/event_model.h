@@ -9,6 +9,7 @@
 
 #include "event.h"
 #include "event_backend_interface.h"
+#include "interval_tree.h"
 
 namespace events {
 /* event_model class
@@ -17,7 +18,7 @@ namespace events {
  */
 class event_model {
 public:
-	event_model() = default;
+	event_model();
 	event_model(const event_model& rhs) = delete;
 	~event_model() = default;
 
@@ -39,9 +40,27 @@ public:
 	/* add_source - add an event source to this model
 	 * @source: shared pointer to the event backend
 	 *
-	 * Adds an source that this model will use for finding events.
+	 * Adds an source that this model will use for finding events. Adding
+	 * the same backend again gives it another source index for
+	 * highlighting but the backend is still updated only once and its
+	 * events are merged only once.
 	 */
 	void add_source(std::shared_ptr<event_backend_interface> source);
+	/* set_conflict_hilight - highlight room conflicts
+	 * @enabled: true to mark the events that overlap another event at the
+	 *           same location
+	 *
+	 * The conflicting events are found when the events are updated.
+	 */
+	void set_conflict_hilight(bool enabled);
+	/* set_keep_descriptions - keep the descriptions of the events
+	 * @enabled: true to keep every description
+	 *
+	 * The descriptions are only shown by other programs reading the
+	 * events, so by default they are dropped unless a rule searches
+	 * them. Enable this when the events are exported.
+	 */
+	void set_keep_descriptions(bool enabled);
 	/* update - try to update the model
 	 *
 	 * Returns true if there are new events.
@@ -53,14 +72,72 @@ public:
 
 	/* events - return the list of events
 	 *
-	 * Returns a list containing the events in this model.
+	 * Returns a reference to the list containing the events in this model.
+	 * The reference stays valid for the lifetime of the model but the
+	 * contents change when update() is called.
+	 */
+	const std::list<event>& events() const;
+	/* in_progress - find the events going on at a time
+	 * @time: the time
+	 *
+	 * Returns the events that have started at or before time and end after
+	 * it, ordered by their start times. The pointers are valid until the
+	 * next call to update().
+	 */
+	std::vector<const event*> in_progress(util::time_point time) const;
+	/* overlapping - find the events overlapping a time range
+	 * @begin: start of the range
+	 * @end: end of the range, not included in it
+	 *
+	 * Returns the events that start before end and end after begin,
+	 * ordered by their start times. The pointers are valid until the next
+	 * call to update().
 	 */
-	std::list<event> events() const;
+	std::vector<const event*> overlapping(util::time_point begin,
+					      util::time_point end) const;
+	/* upcoming - find the next events from some sources
+	 * @time: the time
+	 * @count: maximum number of events
+	 * @sources: source indices of the events, an empty set matches every
+	 *           source
+	 *
+	 * Returns the first count events that haven't ended at time, ordered
+	 * by their start times. The source of a merged event is the source
+	 * it was first provided by. The pointers are valid until the next call
+	 * to update().
+	 */
+	std::vector<const event*> upcoming(util::time_point time,
+					   std::size_t count,
+					   const std::unordered_set<unsigned>& sources = {}) const;
+	/* revision - get the revision of the event list
+	 *
+	 * Returns a number that changes every time the list of events is
+	 * modified. Views can use this to find out if their cached data is
+	 * still valid.
+	 */
+	unsigned long revision() const;
 	
 protected:
+	/* source struct
+	 * This struct holds an event backend and its events
+	 *
+	 * @backend: the event backend
+	 * @events: the last events provided by the backend
+	 * @indices: the source indices the backend has been added with
+	 */
+	struct source {
+		std::shared_ptr<event_backend_interface> backend;
+		std::list<event> events;
+		std::vector<unsigned> indices;
+	};
+
+	bool conflict_hilight_;
 	std::list<event> events_;
-	mutable std::list<std::pair<std::shared_ptr<event_backend_interface>,
-			  std::list<event>>> event_sources_;
+	util::interval_tree<event*> index_;
+	bool keep_descriptions_;
+	unsigned long revision_;
+	unsigned source_count_;
+	std::list<source> event_sources_;
 	std::vector<std::pair<events::search_target,
 			      std::basic_regex<wchar_t>>> regex_rules_;
 	std::unordered_set<unsigned> source_rules_;
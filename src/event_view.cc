@@ -1,34 +1,123 @@
 #include "event_view.h"
 
+#include <algorithm>
 #include <chrono>
-
-using boost::posix_time::second_clock;
+#include <utility>
 
 /* flash_freq - flash the highlighted text at 0.5 Hz */
 constexpr float flash_freq = .5;
+/* empty_height - height of the window shown when there are no events */
+constexpr unsigned empty_height = 5;
 
+/* append_date - append a date to a string
+ * @dst: string to append to
+ * @time: the date to format
+ *
+ * Appends the date formatted as "Mon 1. of Jan 2018"
+ */
+static void append_date(std::wstring& dst, const util::civil_time& time);
+/* append_number - append a number to a string
+ * @dst: string to append to
+ * @value: the number to format
+ * @width: minimum width of the number, padded with zeros
+ */
+static void append_number(std::wstring& dst, long value, unsigned width = 0);
+/* append_time - append time of day to a string
+ * @dst: string to append to
+ * @time: the time of day to format
+ *
+ * Appends the time formatted as "hh:mm"
+ */
+static void append_time(std::wstring& dst, const util::civil_time& time);
+/* event_height - get the height of the window of an event
+ * @event: the event
+ *
+ * Returns the number of lines needed to render the event
+ */
+static unsigned event_height(const events::event& event);
 /* flash hilight - sw flashing timer for event highlighting
  * @freq: flashing frequency
  *
  * Returns true and false periodically depending on the used frequency
  */
 static bool flash_hilight(float freq);
+/* format_date_time - format the date and time range of an event
+ * @dst: string to store the result in
+ * @event: the event to format
+ */
+static void format_date_time(std::wstring& dst, const events::event& event);
+/* format_name - format the name of an event
+ * @dst: string to store the result in
+ * @event: the event to format
+ * @width: available width
+ *
+ * If the name doesn't fit in the width it is shortened
+ */
+static void format_name(std::wstring& dst,
+			const events::event& event,
+			unsigned width);
+/* format_time_until - format the label showing how far away an event is
+ * @dst: string to store the result in
+ * @now: current time
+ * @time_until: time left until the event starts
+ *
+ * Returns the time when the label has to be formatted again
+ */
+static util::time_point format_time_until(std::wstring& dst,
+					  util::time_point now,
+					  std::chrono::seconds time_until);
+
+events::event_view::event_view() :
+	cache_revision_{0},
+	content_height_{0},
+	first_{0},
+	interval_{0},
+	model_{nullptr},
+	mode_{off},
+	next_{0},
+	predecessor_{nullptr},
+	successor_{nullptr}
+{}
 
 void
 events::event_view::set_model(event_model* model)
 {
 	model_ = model;
+	cache_.clear();
+	first_ = 0;
+}
+
+void
+events::event_view::continue_from(event_view* view)
+{
+	predecessor_ = view;
+	view->successor_ = this;
+}
+
+void
+events::event_view::set_paging(paging mode, std::chrono::seconds interval)
+{
+	mode_ = mode;
+	interval_ = interval;
+	first_ = 0;
+	last_advance_ = std::chrono::steady_clock::now();
 }
 
 void
 events::event_view::draw(ui::win& win) const
 {
-	// If the there are no events render a window showing an unhappy face
-	if (model_->events().empty()) {
+	const auto& events = model_->events();
+
+	// If the there are no events render a window showing an unhappy face.
+	// The following views are left empty
+	if (events.empty()) {
+		if (predecessor_)
+			return;
+
 		ui::win event_win{&win,
 				  {win.curx(), win.cury()},
 				  {win.curx() + win.max_width(),
-				  win.cury() + 5}};
+				  win.cury() + empty_height}};
 
 		event_win.newline()
 			 .add_text(L"No events   :(",
@@ -38,15 +127,25 @@ events::event_view::draw(ui::win& win) const
 		return;
 	}
 
-	// Render all of the events in the model
-	for (auto event : model_->events()) {
-		const unsigned location_space = event.location()
-						     .empty() ? 0 : 1;
-		const unsigned event_space = 4 +
-					     location_space;
+	// The cached strings are only valid as long as the model hasn't
+	// changed
+	if (cache_revision_ != model_->revision() or
+	    cache_.size() != events.size())
+		rebuild_cache();
 
-		if (win.remaining_height() < event_space)
-			break;
+	// The first view of a chain controls the paging for all of them
+	if (not predecessor_)
+		advance(std::chrono::steady_clock::now());
+
+	const auto now = util::now();
+
+	// Render only the events that fit in the window starting from the
+	// first visible one
+	for (next_ = first_; next_ < cache_.size(); next_++) {
+		auto& cache = cache_[next_];
+		const auto& event = *cache.item;
+
+		const unsigned event_space = event_height(event);
 
 		if (win.remaining_height() < event_space)
 			break;
@@ -59,127 +158,53 @@ events::event_view::draw(ui::win& win) const
 				  {win.curx() + win.max_width(),
 				  win.cury() + event_space}};
 
-		auto start = event.duration().begin();
-		auto end = event.duration().end();
-		std::wstringstream date_time_ss;
-
-		if (start.date() == end.date())
-			date_time_ss << L"On "
-				     << start.date().day_of_week()
-				     << ' '
-				     << start.date().day()
-				     << L". of "
-				     << start.date().month()
-				     << ' '
-				     << start.date().year()
-				     << L" from "
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << start.time_of_day().hours()
-				     << ':'
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << start.time_of_day().minutes()
-				     << L" to "
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << end.time_of_day().hours()
-				     << ':'
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << end.time_of_day().minutes();
-		else
-			date_time_ss << L"From "
-				     << start.date().day_of_week()
-				     << ' '
-				     << start.date().day()
-				     << L". of "
-				     << start.date().month()
-				     << ' '
-				     << start.date().year()
-				     << ' '
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << start.time_of_day().hours()
-				     << ':'
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << start.time_of_day().minutes()
-				     << L" to "
-				     << end.date().day_of_week()
-				     << ' '
-				     << end.date().day()
-				     << L". of "
-				     << end.date().month()
-				     << ' '
-				     << end.date().year()
-				     << ' '
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << end.time_of_day().hours()
-				     << ':'
-				     << std::setw(2)
-				     << std::setfill(L'0')
-				     << end.time_of_day().minutes();
-
-		std::wstringstream time_until_ss;
-		auto time_until = start - second_clock::local_time();
-
-		if (time_until.is_negative()) {
-			time_until_ss << L"In progress";
-		} else {
-			time_until_ss << L"In ";
-			
-			if (time_until.hours() > 24)
-				time_until_ss << time_until.hours() / 24
-					      << L" d "
-					      << time_until.hours() % 24
-					      << L" h";
-			else if (time_until.hours() > 0)
-				time_until_ss << time_until.hours()
-					      << L" h "
-					      << time_until.minutes()
-					      << L" m";
-			else if (time_until.minutes() > 0)
-				time_until_ss << time_until.minutes()
-					      << L" m";
-			else
-				time_until_ss << L"a jiffy";
+		// Only format the strings that are missing or out of date
+		if (cache.date_time.empty())
+			format_date_time(cache.date_time, event);
+
+		if (cache.name.empty() or
+		    cache.name_width != event_win.max_width()) {
+			format_name(cache.name, event, event_win.max_width());
+			cache.name_width = event_win.max_width();
 		}
 
-		std::wstringstream name_ss;
+		if (cache.time_until.empty() or
+		    now >= cache.time_until_expires) {
+			const auto time_until = event.start() - now;
 
-		if (event.name().length() > event_win.max_width() - 1)
-			name_ss << event.name()
-					.substr(0, event_win.max_width() - 4)
-				<< "...";
-		else
-			name_ss << event.name();
+			cache.time_until_expires = format_time_until(cache.time_until,
+								     now,
+								     time_until);
+			cache.in_progress = time_until.count() < 0;
+		}
 
 		if (event.hilight()) {
-			event_win.add_text(name_ss.str(),
+			event_win.add_text(cache.name,
 					   flash_hilight(flash_freq) ?
 					   ui::effect::reverse | ui::effect::bold :
 					   ui::effect::bold)
 				 .newline();
 		} else {
-			event_win.add_text(name_ss.str(),
+			event_win.add_text(cache.name,
 					   ui::effect::bold)
 				 .newline();
 		}
 
+		// Another event is held at the same location at the same time
 		if (not event.location().empty()) {
-			 event_win.add_text(event.location().data(),
+			 event_win.add_text(event.location(),
+					    event.conflict() ?
+					    ui::effect::reverse :
 					    ui::effect::normal,
 					    ui::align::left)
 				  .newline();
 		}
 
-		event_win.add_text(date_time_ss.str(),
+		event_win.add_text(cache.date_time,
 				   ui::effect::normal,
 				   ui::align::append)
-			 .add_text(time_until_ss.str(),
-				   time_until.is_negative() ?
+			 .add_text(cache.time_until,
+				   cache.in_progress ?
 				   ui::effect::bold : 
 				   ui::effect::normal,
 				   ui::align::right)
@@ -187,15 +212,231 @@ events::event_view::draw(ui::win& win) const
 
 		event_win.draw();
 	}
+
+	// The next view continues from the first event that didn't fit
+	if (successor_) {
+		successor_->first_ = next_;
+		successor_->next_ = next_;
+	}
 }
 
 unsigned
 events::event_view::height() const
 {
-	return 0;
+	if (not model_)
+		return 0;
+
+	if (cache_revision_ != model_->revision() or
+	    cache_.size() != model_->events().size())
+		rebuild_cache();
+
+	return content_height_;
+}
+
+void
+events::event_view::advance(std::chrono::steady_clock::time_point now) const
+{
+	if (mode_ == off or now - last_advance_ < interval_)
+		return;
+
+	last_advance_ = now;
+
+	// A page includes the events shown by the following views
+	auto last = this;
+	while (last->successor_)
+		last = last->successor_;
+
+	const auto next = std::max(next_, last->next_);
+
+	// Start again from the beginning once the last event has been shown
+	if (next >= cache_.size()) {
+		first_ = 0;
+		return;
+	}
+
+	// Always move forward at least one event so that a window too small
+	// for a single event doesn't get stuck
+	if (mode_ == page)
+		first_ = std::max(next, first_ + 1);
+	else
+		first_++;
+}
+
+void
+events::event_view::rebuild_cache() const
+{
+	const auto& events = model_->events();
+
+	cache_.clear();
+	cache_.reserve(events.size());
+	content_height_ = events.empty() ? empty_height : 0;
+
+	for (const auto& event : events) {
+		render_cache cache;
+		cache.item = &event;
+
+		cache_.push_back(std::move(cache));
+		content_height_ += event_height(event);
+	}
+
+	cache_revision_ = model_->revision();
+
+	// The position of a following view is set by the preceding one
+	if (predecessor_)
+		return;
+
+	if (first_ >= cache_.size())
+		first_ = 0;
+
+	next_ = first_;
+}
+
+static void
+append_date(std::wstring& dst, const util::civil_time& time)
+{
+	static constexpr const wchar_t* weekdays[] = {L"Sun", L"Mon", L"Tue",
+						      L"Wed", L"Thu", L"Fri",
+						      L"Sat"};
+	static constexpr const wchar_t* months[] = {L"Jan", L"Feb", L"Mar",
+						    L"Apr", L"May", L"Jun",
+						    L"Jul", L"Aug", L"Sep",
+						    L"Oct", L"Nov", L"Dec"};
+
+	dst.append(weekdays[time.weekday]);
+	dst.push_back(L' ');
+	append_number(dst, time.day);
+	dst.append(L". of ");
+	dst.append(months[time.month - 1]);
+	dst.push_back(L' ');
+	append_number(dst, time.year);
+}
+
+static void
+append_number(std::wstring& dst, long value, unsigned width)
+{
+	wchar_t buffer[24];
+	wchar_t* end = buffer + sizeof(buffer)/sizeof(buffer[0]);
+	wchar_t* begin = end;
+	const bool negative = value < 0;
+	unsigned long abs_value = negative ? -static_cast<unsigned long>(value) :
+					     static_cast<unsigned long>(value);
+
+	do {
+		*--begin = L'0' + abs_value % 10;
+		abs_value /= 10;
+	} while (abs_value != 0);
+
+	while (static_cast<unsigned>(end - begin) < width and begin != buffer + 1)
+		*--begin = L'0';
+
+	if (negative)
+		*--begin = L'-';
+
+	dst.append(begin, end);
+}
+
+static void
+append_time(std::wstring& dst, const util::civil_time& time)
+{
+	append_number(dst, time.hour, 2);
+	dst.push_back(L':');
+	append_number(dst, time.minute, 2);
+}
+
+static void
+format_date_time(std::wstring& dst, const events::event& event)
+{
+	const auto start = util::to_local(event.start());
+	const auto end = util::to_local(event.end());
+
+	dst.clear();
+
+	if (start.year == end.year and start.month == end.month and
+	    start.day == end.day) {
+		dst.append(L"On ");
+		append_date(dst, start);
+		dst.append(L" from ");
+		append_time(dst, start);
+		dst.append(L" to ");
+		append_time(dst, end);
+	} else {
+		dst.append(L"From ");
+		append_date(dst, start);
+		dst.push_back(L' ');
+		append_time(dst, start);
+		dst.append(L" to ");
+		append_date(dst, end);
+		dst.push_back(L' ');
+		append_time(dst, end);
+	}
+}
+
+static void
+format_name(std::wstring& dst, const events::event& event, unsigned width)
+{
+	const auto name = event.name();
+
+	dst.clear();
+
+	if (name.length() > width - 1) {
+		dst.append(name.substr(0, width - 4));
+		dst.append(L"...");
+	} else {
+		dst.append(name);
+	}
+}
+
+static util::time_point
+format_time_until(std::wstring& dst,
+		  util::time_point now,
+		  std::chrono::seconds time_until)
+{
+	dst.clear();
+
+	// An event in progress stays in progress until it is removed from
+	// the model so the label never has to be formatted again
+	if (time_until.count() < 0) {
+		dst.append(L"In progress");
+
+		return util::time_point::max();
+	}
+
+	const long hours = time_until.count() / 3600;
+	const long minutes = time_until.count() / 60 % 60;
+
+	dst.append(L"In ");
+
+	if (hours > 24) {
+		append_number(dst, hours / 24);
+		dst.append(L" d ");
+		append_number(dst, hours % 24);
+		dst.append(L" h");
+	} else if (hours > 0) {
+		append_number(dst, hours);
+		dst.append(L" h ");
+		append_number(dst, minutes);
+		dst.append(L" m");
+	} else if (minutes > 0) {
+		append_number(dst, minutes);
+		dst.append(L" m");
+	} else {
+		dst.append(L"a jiffy");
+	}
+
+	// The label only changes when the remaining time crosses a minute
+	// boundary
+	return now + std::chrono::seconds(time_until.count() % 60 + 1);
+}
+
+static unsigned
+event_height(const events::event& event)
+{
+	// Name, date and time, and the borders. Location takes an extra line
+	return event.location().empty() ? 4 : 5;
 }
 
-static bool flash_hilight(float freq)
+static bool
+flash_hilight(float freq)
 {
 	static bool use_bold = true;
 	static std::chrono::time_point<std::chrono::steady_clock> last_change;
@@ -1,8 +1,11 @@
 #pragma once
 
+#include <chrono>
 #include <string>
+#include <vector>
 
 #include "event_model.h"
+#include "local_time.h"
 #include "view_interface.h"
 
 namespace events {
@@ -12,8 +15,20 @@ namespace events {
  */
 class event_view : public view_interface {
 public:
-	/* event_view - explicitly defaulted ctor */
-	event_view() = default;
+	/* enum paging
+	 * Describes how the view moves through events that don't fit on the
+	 * screen at once.
+	 *
+	 * @off: only the first screenful of events is shown
+	 * @page: the view flips to the next screenful of events
+	 * @scroll: the view scrolls forward one event at a time
+	 */
+	enum paging { off,
+		      page,
+		      scroll };
+
+	/* event_view - ctor */
+	event_view();
 	/* event_view - explicitly deleted copy ctor */
 	event_view(const event_view& rhs) = delete;
 
@@ -26,12 +41,76 @@ public:
 	 * This function sets the event model as the source data for this view
 	 */
 	void set_model(event_model* model);
+	/* continue_from - show the events following another view
+	 * @view: pointer to the preceding event_view
+	 *
+	 * Makes this view show the events that didn't fit in the preceding
+	 * view. This way multiple views (e.g. in multiple columns) can share a
+	 * single list of events. The preceding view has to be drawn first and
+	 * it controls the paging of the whole chain.
+	 */
+	void continue_from(event_view* view);
+	/* set_paging - set how the view moves through the events
+	 * @mode: paging mode to use
+	 * @interval: how long each page or scroll position is shown
+	 *
+	 * When the view reaches the end of the events it starts again from the
+	 * first one.
+	 */
+	void set_paging(paging mode, std::chrono::seconds interval);
 
 	/* implemented from view_interface */
 	void draw(ui::win& win) const override;
 	unsigned height() const override;
 	
 protected:
+	/* render_cache struct
+	 * This struct holds the preformatted strings of a single event so that
+	 * they don't have to be formatted again on every frame. The strings are
+	 * formatted only when the event becomes visible.
+	 *
+	 * @item: the event in the model
+	 * @date_time: date and time range of the event
+	 * @name: name of the event truncated to name_width
+	 * @name_width: the width used when truncating the name
+	 * @time_until: label showing how far away the event is
+	 * @time_until_expires: time when time_until has to be formatted again
+	 * @in_progress: true if the event was in progress when time_until was
+	 * 		 formatted
+	 */
+	struct render_cache {
+		const event* item = nullptr;
+		std::wstring date_time;
+		std::wstring name;
+		unsigned name_width = 0;
+		std::wstring time_until;
+		util::time_point time_until_expires;
+		bool in_progress = false;
+	};
+
+	/* advance - move to the next page or scroll position
+	 * @now: current time
+	 *
+	 * Moves first_ forward if the paging interval has passed
+	 */
+	void advance(std::chrono::steady_clock::time_point now) const;
+	/* rebuild_cache - rebuild the render cache from the model
+	 *
+	 * Creates an empty cache entry for every event in the model and
+	 * computes the height of the content
+	 */
+	void rebuild_cache() const;
+
+	mutable std::vector<render_cache> cache_;
+	mutable unsigned long cache_revision_;
+	mutable unsigned content_height_;
+	mutable std::size_t first_;
+	std::chrono::seconds interval_;
+	mutable std::chrono::steady_clock::time_point last_advance_;
 	event_model* model_;
+	paging mode_;
+	mutable std::size_t next_;
+	event_view* predecessor_;
+	event_view* successor_;
 };
 }
@@ -0,0 +1,92 @@
+#include "file_backend.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <sys/inotify.h>
+#include <unistd.h>
+
+#include "parser.h"
+
+events::file_backend::file_backend(const std::string& path) :
+	changed_{true},
+	inotify_fd_{-1},
+	path_{path}
+{
+	// The directory is watched instead of the file so that a file
+	// replaced by a rename is noticed as well
+	const auto slash = path_.rfind('/');
+	const std::string dir = slash == std::string::npos ? "." :
+				slash == 0 ? "/" : path_.substr(0, slash);
+
+	name_ = slash == std::string::npos ? path_ : path_.substr(slash + 1);
+
+	inotify_fd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+	if (inotify_fd_ < 0)
+		throw std::runtime_error{"failed to initialize inotify"};
+
+	if (inotify_add_watch(inotify_fd_, dir.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+		close(inotify_fd_);
+		throw std::runtime_error{"failed to watch " + dir};
+	}
+}
+
+events::file_backend::~file_backend()
+{
+	close(inotify_fd_);
+}
+
+void
+events::file_backend::lower_cooldown()
+{
+	// Nothing to do, ready() waits for the file to change
+}
+
+std::optional<std::list<events::event>>
+events::file_backend::update()
+{
+	changed_ = false;
+
+	std::ifstream in{path_, std::ios::in | std::ios::binary};
+	if (not in)
+		return std::nullopt;
+
+	std::ostringstream data;
+	data << in.rdbuf();
+
+	try {
+		return parser::events_from_feed(data.str(), {util::now()},
+						std::thread::hardware_concurrency());
+	} catch (...) {
+		return std::nullopt;
+	}
+}
+
+const std::string&
+events::file_backend::path() const
+{
+	return path_;
+}
+
+bool
+events::file_backend::ready() const
+{
+	alignas(inotify_event) char buffer[4096];
+	ssize_t length;
+
+	// Drain the queued notifications and look for the watched file
+	while ((length = read(inotify_fd_, buffer, sizeof(buffer))) > 0) {
+		for (char* p = buffer; p < buffer + length; ) {
+			const auto event = reinterpret_cast<const inotify_event*>(p);
+
+			if (event->len > 0 and name_ == event->name)
+				changed_ = true;
+
+			p += sizeof(inotify_event) + event->len;
+		}
+	}
+
+	return changed_;
+}
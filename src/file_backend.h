@@ -0,0 +1,60 @@
+#pragma once
+
+#include <list>
+#include <optional>
+#include <string>
+
+#include "event.h"
+#include "event_backend_interface.h"
+
+namespace events {
+/* file_backend class
+ * This class provides events from a local ics or Google json file. The
+ * directory of the file is watched with inotify and the file is read again
+ * every time it is written or replaced. This allows replaying recorded feeds
+ * without a network connection.
+ */
+class file_backend : public event_backend_interface {
+public:
+	/* ctor
+	 * @path: path to the file
+	 *
+	 * Throws std::runtime_error if the directory of the file can't be
+	 * watched
+	 */
+	file_backend(const std::string& path);
+	/* explicitly deleted copy ctor */
+	file_backend(const file_backend& rhs) = delete;
+
+	/* dtor
+	 *
+	 * This function stops watching the directory
+	 */
+	~file_backend();
+
+	/* lower_cooldown - implemented from the event_backend_interface
+	 *
+	 * A file that couldn't be read is tried again once it changes
+	 */
+	void lower_cooldown() override;
+	/* update - implemented from the event_backend_interface */
+	std::optional<std::list<event>> update() override;
+
+	/* path - get the path
+	 *
+	 * Returns the path of the file
+	 */
+	const std::string& path() const;
+	/* ready - implemented from the event_backend_interface
+	 *
+	 * Returns true if the file has changed since the last update
+	 */
+	bool ready() const override;
+
+protected:
+	mutable bool changed_;
+	int inotify_fd_;
+	std::string name_;
+	std::string path_;
+};
+}
@@ -1,34 +1,43 @@
 #include "google_calendar_backend.h"
 
+#include <iomanip>
+#include <sstream>
+
+#include "local_time.h"
 #include "parser.h"
 
-using boost::posix_time::seconds;
-using boost::posix_time::min_date_time;
-using boost::posix_time::second_clock;
+using std::chrono::hours;
+using std::chrono::minutes;
+using std::chrono::seconds;
+
+/* quota_exceeded - check if a request failed because of a quota
+ * @error: the error returned for the request
+ *
+ * Returns true if the Google API refused the request because a rate limit
+ * or the daily quota was exceeded
+ */
+static bool quota_exceeded(const events::http_error& error);
 
 events::google_calendar_backend::google_calendar_backend() :
-	cooldown_{1, 0, 0, 0},
-	error_cooldown_{0, 10, 0, 0},
-	last_update_{min_date_time},
-	was_error_{false}
+	schedule_{hours(1), minutes(10)}
 {}
 
 void
 events::google_calendar_backend::lower_cooldown()
 {
-	was_error_ = true;
+	schedule_.fail();
 }
 
 void
 events::google_calendar_backend::set_cooldown(unsigned long secs)
 {
-	cooldown_ = seconds(secs);
+	schedule_.set_cooldown(seconds(secs));
 }
 
 void
 events::google_calendar_backend::set_error_cooldown(unsigned long secs)
 {
-	error_cooldown_ = seconds(secs);
+	schedule_.set_error_cooldown(seconds(secs));
 }
 
 void
@@ -47,37 +56,34 @@ std::optional<std::list<events::event>>
 events::google_calendar_backend::update()
 {
 	// Format the Google API request using UTC time to make things easier
-	auto now = second_clock::universal_time();
-
-	auto today = now.date();
-	auto time = now.time_of_day();
+	const auto now = util::to_utc(util::now());
 
 	std::stringstream request_ss;
 	request_ss << "https://www.googleapis.com/calendar/v3/calendars/"
 		   << id_
 		   << "/events?"
 		   << "timeMin="
-		   << today.year()
+		   << now.year
 		   << '-'
 		   << std::setw(2)
 		   << std::setfill('0')
-		   << int(today.month())
+		   << now.month
 		   << '-'
 		   << std::setw(2)
 		   << std::setfill('0')
-		   << today.day()
+		   << now.day
 		   << 'T'
 		   << std::setw(2)
 		   << std::setfill('0')
-		   << time.hours()
+		   << now.hour
 		   << ':'
 		   << std::setw(2)
 		   << std::setfill('0')
-		   << time.minutes()
+		   << now.minute
 		   << ':'
 		   << std::setw(2)
 		   << std::setfill('0')
-		   << time.seconds()
+		   << now.second
 		   << 'Z'
 		   << "&orderBy=startTime"
 		   << "&singleEvents=true"
@@ -89,43 +95,55 @@ events::google_calendar_backend::update()
 	std::string response;
 	bool success;
 
+	schedule_.start();
+
 	try {
 		response = db_.get_response();
 		success = true;
+	} catch (const http_error& e) {
+		// Google reports exhausted quotas without a Retry-After header,
+		// retrying before the next regular update would only fail again
+		if (e.retry_after() > 0)
+			schedule_.retry_after(seconds(e.retry_after()));
+		else if (quota_exceeded(e))
+			schedule_.retry_after(schedule_.cooldown());
+
+		success = false;
 	} catch (...) {
 		success = false;
 	}
 
-	last_update_ = second_clock::universal_time();
-
 	if (success) {
-		std::list<event> events;
-
-		try {
-			events = parser::events_from_json(response);
-		} catch (...) {
-			return std::nullopt;
+		// The parser is skipped if the body is the same that was
+		// parsed the last time
+		if (parsed_hash_ != db_.content_hash()) {
+			try {
+				parsed_events_ = parser::events_from_json(response, {util::now()});
+			} catch (...) {
+				return std::nullopt;
+			}
+
+			parsed_hash_ = db_.content_hash();
 		}
 
-		if (was_error_)
-			was_error_ = false;
+		schedule_.succeed();
 
-		return events;
+		return parsed_events_;
 	}
 
 	return std::nullopt;
 }
 
-time_duration
+std::chrono::seconds
 events::google_calendar_backend::cooldown() const
 {
-	return cooldown_;
+	return schedule_.cooldown();
 }
 
-time_duration
+std::chrono::seconds
 events::google_calendar_backend::error_cooldown() const
 {
-	return error_cooldown_;
+	return schedule_.error_cooldown();
 }
 
 std::string_view
@@ -143,10 +161,16 @@ events::google_calendar_backend::key() const
 bool
 events::google_calendar_backend::ready() const
 {
-	auto diff = second_clock::universal_time() - last_update_;
-	
-	if (was_error_)
-		return diff >= error_cooldown_;
-	else
-		return diff >= cooldown_;
+	return schedule_.ready();
+}
+
+static bool
+quota_exceeded(const events::http_error& error)
+{
+	if (error.status() == 429)
+		return true;
+
+	return error.status() == 403 and
+	       (error.body().find("rateLimitExceeded") != std::string_view::npos or
+		error.body().find("quotaExceeded") != std::string_view::npos);
 }
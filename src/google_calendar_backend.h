@@ -1,18 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <list>
 #include <optional>
 #include <string>
 #include <string_view>
 
-#include <boost/date_time.hpp>
-
 #include "db_connection.h"
 #include "event.h"
 #include "event_backend_interface.h"
-
-using boost::posix_time::ptime;
-using boost::posix_time::time_duration;
+#include "refresh_schedule.h"
 
 namespace events {
 /* google_calendar_backend class
@@ -59,16 +57,14 @@ public:
 
 	/* cooldown - get the cooldown value
 	 *
-	 * Returns boost::posix_time::time_duration representation of the
-	 * cooldown.
+	 * Returns the cooldown
 	 */
-	time_duration cooldown() const;
+	std::chrono::seconds cooldown() const;
 	/* error_cooldown - ge the error cooldown value
 	 *
-	 * Returns boost::posix_time::time_duration representation of the 
-	 * error cooldown value.
+	 * Returns the error cooldown
 	 */
-	time_duration error_cooldown() const;
+	std::chrono::seconds error_cooldown() const;
 	/* id - get the calendar id
 	 *
 	 * Returns a string view to the calendar id
@@ -83,12 +79,11 @@ public:
 	bool ready() const override;
 
 protected:
-	time_duration cooldown_;
 	db_connection db_;
-	time_duration error_cooldown_;
 	std::string id_;
 	std::string key_;
-	ptime last_update_;
-	bool was_error_;
+	std::list<event> parsed_events_;
+	std::optional<std::uint64_t> parsed_hash_;
+	refresh_schedule schedule_;
 };
 }
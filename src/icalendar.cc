@@ -32,6 +32,83 @@ static std::pair<std::string, std::string> parse_property(const std::string& lin
  */
 static std::string trim(const std::string& str,
 			const std::string& whitespace = " \r");
+/* trim_view - remove whitespace from both ends of a view
+ * @str: the view to trim
+ */
+static std::string_view trim_view(std::string_view str);
+
+icalendar::reader::reader(std::string_view src) :
+	pos_{0},
+	src_{src}
+{}
+
+bool
+icalendar::reader::next(content_line& line)
+{
+	while (pos_ < src_.size()) {
+		auto end = src_.find('\n', pos_);
+
+		if (end == std::string_view::npos)
+			end = src_.size();
+
+		const auto text = trim_view(src_.substr(pos_, end - pos_));
+
+		pos_ = end + 1;
+
+		if (text.empty())
+			continue;
+
+		const auto colon = text.find(':');
+
+		if (colon == std::string_view::npos)
+			throw std::runtime_error{"failed to parse property"};
+
+		line.name = trim_view(text.substr(0, colon));
+		line.value = trim_view(text.substr(colon + 1));
+
+		return true;
+	}
+
+	return false;
+}
+
+bool
+icalendar::reader::skip(std::string_view name)
+{
+	while (pos_ < src_.size()) {
+		// Look for "END:<name>" at the start of a line
+		const auto found = src_.find("END:", pos_);
+
+		if (found == std::string_view::npos)
+			break;
+
+		auto line_start = src_.rfind('\n', found);
+		line_start = line_start == std::string_view::npos ? 0 : line_start + 1;
+
+		auto end = src_.find('\n', found);
+
+		if (end == std::string_view::npos)
+			end = src_.size();
+
+		pos_ = end + 1;
+
+		const auto text = trim_view(src_.substr(line_start, end - line_start));
+
+		if (text.size() == name.size() + 4 and
+		    text.compare(0, 4, "END:") == 0 and text.substr(4) == name)
+			return true;
+	}
+
+	pos_ = src_.size();
+
+	return false;
+}
+
+std::string_view
+icalendar::reader::rest() const
+{
+	return pos_ < src_.size() ? src_.substr(pos_) : std::string_view{};
+}
 
 icalendar::node
 icalendar::parse(const std::string& src)
@@ -126,3 +203,14 @@ trim(const std::string& str, const std::string& whitespace)
 
 	return str.substr(begin, len);
 }
+
+static std::string_view
+trim_view(std::string_view str)
+{
+	const auto begin = str.find_first_not_of(" \r");
+
+	if (begin == std::string_view::npos)
+		return {};
+
+	return str.substr(begin, str.find_last_not_of(" \r") - begin + 1);
+}
@@ -4,6 +4,7 @@
 #include <list>
 #include <map>
 #include <string>
+#include <string_view>
 #include <vector>
 #include <utility>
 
@@ -52,6 +53,53 @@ struct node {
 	std::map<std::string, std::list<node>> subnodes;
 };
 
+/* content_line struct
+ * This struct holds a single line of icalendar data. Both parts refer to
+ * the source data and have the surrounding whitespace removed.
+ *
+ * @name: name of the property including its parameters, e.g.
+ *        "DTEND;TZID=Europe/Helsinki"
+ * @value: value of the property
+ */
+struct content_line {
+	std::string_view name;
+	std::string_view value;
+};
+
+/* reader class
+ * This class reads icalendar data one line at a time without copying it.
+ * Unlike parse() it doesn't build a tree, so the caller can decide to skip
+ * a component after reading only a few of its properties.
+ */
+class reader {
+public:
+	/* reader - ctor
+	 * @src: the icalendar data, has to outlive the reader
+	 */
+	explicit reader(std::string_view src);
+
+	/* next - read the next line
+	 * @line: the line read
+	 *
+	 * Returns false if there are no more lines. Empty lines are skipped.
+	 * Throws std::runtime_error if a line is not a property.
+	 */
+	bool next(content_line& line);
+	/* skip - skip the rest of a component
+	 * @name: name of the component
+	 *
+	 * Moves past the line ending the component without looking at the
+	 * lines in between. Returns false if the component doesn't end.
+	 */
+	bool skip(std::string_view name);
+	/* rest - get the data that hasn't been read yet */
+	std::string_view rest() const;
+
+protected:
+	std::size_t pos_;
+	std::string_view src_;
+};
+
 /* parse - parse the icalendar data
  * @src: string containing icalendar data
  *
@@ -0,0 +1,258 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <utility>
+#include <vector>
+
+#include "local_time.h"
+
+namespace util {
+/* interval_tree class
+ * This class stores values with a time interval [start, end) and finds the
+ * ones overlapping a given interval in O(log n + k) time.
+ *
+ * The tree is a treap ordered by the start time and then by the value. Each
+ * node also stores the latest end time of its subtree, so the subtrees that
+ * can't overlap are never visited. The nodes live in a vector and refer to
+ * each other by index.
+ *
+ * The value type has to be copyable and ordered by std::less. A value can
+ * be stored more than once as long as its start times differ.
+ */
+template<typename T>
+class interval_tree {
+public:
+	interval_tree() :
+		root_{none},
+		free_{none},
+		size_{0},
+		seed_{0x9e3779b9}
+	{}
+
+	/* clear - remove every value */
+	void clear()
+	{
+		nodes_.clear();
+		root_ = none;
+		free_ = none;
+		size_ = 0;
+	}
+
+	/* insert - add a value
+	 * @start: start of the interval
+	 * @end: end of the interval, not included in it
+	 * @value: the value
+	 */
+	void insert(time_point start, time_point end, T value)
+	{
+		std::uint32_t index;
+
+		if (free_ != none) {
+			index = free_;
+			free_ = nodes_[index].left;
+			nodes_[index] = node{start, end, end, std::move(value),
+					     random(), none, none};
+		} else {
+			index = nodes_.size();
+			nodes_.push_back(node{start, end, end, std::move(value),
+					      random(), none, none});
+		}
+
+		std::uint32_t left, right;
+
+		split(root_, nodes_[index].start, nodes_[index].value, left, right);
+		root_ = merge(merge(left, index), right);
+		size_++;
+	}
+
+	/* erase - remove a value
+	 * @start: start of the interval the value was inserted with
+	 * @value: the value
+	 *
+	 * Returns false if the value wasn't found.
+	 */
+	bool erase(time_point start, const T& value)
+	{
+		return erase(root_, start, value);
+	}
+
+	/* overlapping - visit the values overlapping an interval
+	 * @begin: start of the interval
+	 * @end: end of the interval, not included in it
+	 * @f: function called with the interval and value of every
+	 *     overlapping node. Returning false stops the search.
+	 *
+	 * The values are visited in the order of their start times. Returns
+	 * false if f stopped the search.
+	 */
+	template<typename F>
+	bool overlapping(time_point begin, time_point end, F&& f) const
+	{
+		return visit(root_, begin, end, f);
+	}
+
+	/* size - get the number of values */
+	std::size_t size() const
+	{
+		return size_;
+	}
+
+private:
+	static constexpr std::uint32_t none = UINT32_MAX;
+
+	/* node struct
+	 * @start: start of the interval
+	 * @end: end of the interval
+	 * @max_end: latest end in the subtree of the node
+	 * @value: the value
+	 * @priority: heap priority of the treap
+	 * @left: left child or, for free nodes, the next free node
+	 * @right: right child
+	 */
+	struct node {
+		time_point start;
+		time_point end;
+		time_point max_end;
+		T value;
+		std::uint32_t priority;
+		std::uint32_t left;
+		std::uint32_t right;
+	};
+
+	/* less - order of the nodes */
+	static bool less(time_point lhs_start, const T& lhs,
+			 time_point rhs_start, const T& rhs)
+	{
+		if (lhs_start != rhs_start)
+			return lhs_start < rhs_start;
+
+		return std::less<T>{}(lhs, rhs);
+	}
+
+	/* random - get the next priority, xorshift32 */
+	std::uint32_t random()
+	{
+		seed_ ^= seed_ << 13;
+		seed_ ^= seed_ >> 17;
+		seed_ ^= seed_ << 5;
+
+		return seed_;
+	}
+
+	/* update - recalculate the latest end of a subtree */
+	void update(std::uint32_t index)
+	{
+		node& n = nodes_[index];
+
+		n.max_end = n.end;
+
+		if (n.left != none)
+			n.max_end = std::max(n.max_end, nodes_[n.left].max_end);
+		if (n.right != none)
+			n.max_end = std::max(n.max_end, nodes_[n.right].max_end);
+	}
+
+	/* split - split a subtree to the nodes before a key and the rest */
+	void split(std::uint32_t index, time_point start, const T& value,
+		   std::uint32_t& left, std::uint32_t& right)
+	{
+		if (index == none) {
+			left = right = none;
+			return;
+		}
+
+		node& n = nodes_[index];
+
+		if (less(n.start, n.value, start, value)) {
+			split(n.right, start, value, nodes_[index].right, right);
+			left = index;
+		} else {
+			split(n.left, start, value, left, nodes_[index].left);
+			right = index;
+		}
+
+		update(index);
+	}
+
+	/* merge - merge two subtrees, every node of left is before right */
+	std::uint32_t merge(std::uint32_t left, std::uint32_t right)
+	{
+		if (left == none)
+			return right;
+		if (right == none)
+			return left;
+
+		if (nodes_[left].priority > nodes_[right].priority) {
+			nodes_[left].right = merge(nodes_[left].right, right);
+			update(left);
+			return left;
+		}
+
+		nodes_[right].left = merge(left, nodes_[right].left);
+		update(right);
+		return right;
+	}
+
+	bool erase(std::uint32_t& index, time_point start, const T& value)
+	{
+		if (index == none)
+			return false;
+
+		node& n = nodes_[index];
+		bool found;
+
+		if (less(start, value, n.start, n.value)) {
+			found = erase(n.left, start, value);
+		} else if (less(n.start, n.value, start, value)) {
+			found = erase(n.right, start, value);
+		} else {
+			const std::uint32_t removed = index;
+
+			index = merge(n.left, n.right);
+			nodes_[removed].left = free_;
+			free_ = removed;
+			size_--;
+
+			return true;
+		}
+
+		if (found)
+			update(index);
+
+		return found;
+	}
+
+	template<typename F>
+	bool visit(std::uint32_t index, time_point begin, time_point end, F& f) const
+	{
+		if (index == none)
+			return true;
+
+		const node& n = nodes_[index];
+
+		// Nothing in this subtree ends after the interval begins
+		if (n.max_end <= begin)
+			return true;
+
+		if (not visit(n.left, begin, end, f))
+			return false;
+
+		// The right subtree and this node start too late
+		if (n.start >= end)
+			return true;
+
+		if (n.end > begin and not f(n.start, n.end, n.value))
+			return false;
+
+		return visit(n.right, begin, end, f);
+	}
+
+	std::vector<node> nodes_;
+	std::uint32_t root_;
+	std::uint32_t free_;
+	std::size_t size_;
+	std::uint32_t seed_;
+};
+}
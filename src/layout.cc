@@ -0,0 +1,206 @@
+#include "layout.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+/* x_margin - space between the main window and the screen edges */
+constexpr unsigned x_margin = 2;
+/* y_margin - space between the main window and the screen edges */
+constexpr unsigned y_margin = 1;
+/* x_border - space taken by the border of the main window */
+constexpr unsigned x_border = 2;
+/* y_border - space taken by the border of the main window */
+constexpr unsigned y_border = 1;
+/* column_gap - space between two columns */
+constexpr unsigned column_gap = 1;
+
+ui::layout::layout() :
+	columns_{1},
+	dirty_{true},
+	min_column_width_{0},
+	screen_size_{0, 0}
+{}
+
+void
+ui::layout::add_view(view_interface* view, unsigned column)
+{
+	views_.emplace_back(view, column);
+	heights_.push_back(0);
+	dirty_ = true;
+}
+
+void
+ui::layout::invalidate()
+{
+	dirty_ = true;
+}
+
+void
+ui::layout::set_columns(unsigned columns, unsigned min_width)
+{
+	if (columns == 0)
+		throw std::invalid_argument{"layout needs at least one column"};
+
+	columns_ = columns;
+	min_column_width_ = min_width;
+	dirty_ = true;
+}
+
+void
+ui::layout::set_screen_size(std::pair<unsigned, unsigned> size)
+{
+	if (size == screen_size_)
+		return;
+
+	screen_size_ = size;
+	dirty_ = true;
+
+	// The subwindows have to be freed before their parent
+	windows_.clear();
+	main_win_.reset();
+}
+
+void
+ui::layout::draw()
+{
+	const auto [screen_width, screen_height] = screen_size_;
+
+	if (screen_width <= 2*(x_margin + x_border) or
+	    screen_height <= 2*(y_margin + y_border))
+		return;
+
+	if (measure() or dirty_)
+		place();
+
+	if (not main_win_)
+		main_win_ = std::make_unique<win>(std::pair{x_margin, y_margin},
+						  std::pair{screen_width - x_margin,
+						  screen_height - y_margin});
+	else
+		main_win_->clear();
+
+	if (windows_.empty())
+		for (const auto& r : regions_)
+			windows_.push_back(std::make_unique<win>(main_win_.get(),
+								 r.from,
+								 r.to,
+								 false));
+
+	for (unsigned i = 0; i < regions_.size(); i++) {
+		windows_[i]->clear();
+		regions_[i].view->draw(*windows_[i]);
+	}
+
+	main_win_->draw();
+}
+
+const std::vector<ui::layout::region>&
+ui::layout::regions()
+{
+	if (measure() or dirty_)
+		place();
+
+	return regions_;
+}
+
+bool
+ui::layout::measure()
+{
+	bool changed = false;
+
+	for (unsigned i = 0; i < views_.size(); i++) {
+		const unsigned height = views_[i].first->height();
+
+		if (height != heights_[i]) {
+			heights_[i] = height;
+			changed = true;
+		}
+	}
+
+	return changed;
+}
+
+void
+ui::layout::place()
+{
+	dirty_ = false;
+	regions_.clear();
+	windows_.clear();
+
+	const auto [screen_width, screen_height] = screen_size_;
+
+	if (screen_width <= 2*(x_margin + x_border) or
+	    screen_height <= 2*(y_margin + y_border))
+		return;
+
+	// The area inside the border of the main window
+	const unsigned width = screen_width - 2*(x_margin + x_border);
+	const unsigned height = screen_height - 2*(y_margin + y_border);
+
+	unsigned columns = columns_;
+	if (min_column_width_ > 0)
+		columns = std::clamp((width + column_gap) /
+				     (min_column_width_ + column_gap),
+				     1u, columns_);
+
+	// Views spanning all of the columns are stacked at the top
+	unsigned top = 0;
+
+	for (unsigned i = 0; i < views_.size(); i++) {
+		if (views_[i].second != all_columns)
+			continue;
+
+		const unsigned view_height = std::min(heights_[i],
+						      height - top);
+		if (view_height == 0)
+			continue;
+
+		regions_.push_back(region{views_[i].first,
+					  {x_border, y_border + top},
+					  {x_border + width,
+					   y_border + top + view_height}});
+		top += view_height;
+	}
+
+	// The rest of the space is divided between the columns. Views in
+	// columns that don't fit on the screen go to the last column
+	const unsigned column_width = (width - (columns - 1)*column_gap) /
+				      columns;
+
+	for (unsigned column = 0; column < columns; column++) {
+		std::vector<unsigned> column_views;
+
+		for (unsigned i = 0; i < views_.size(); i++) {
+			const unsigned c = views_[i].second;
+
+			if (c == all_columns)
+				continue;
+
+			if (std::min(c, columns - 1) == column)
+				column_views.push_back(i);
+		}
+
+		const unsigned left = x_border + column*(column_width + column_gap);
+		const unsigned right = column == columns - 1 ?
+				       x_border + width :
+				       left + column_width;
+		unsigned y = top;
+
+		for (unsigned j = 0; j < column_views.size(); j++) {
+			const unsigned i = column_views[j];
+			const bool last = j == column_views.size() - 1;
+			const unsigned view_height = last ?
+						     height - y :
+						     std::min(heights_[i],
+							      height - y);
+
+			if (view_height == 0)
+				continue;
+
+			regions_.push_back(region{views_[i].first,
+						  {left, y_border + y},
+						  {right, y_border + y + view_height}});
+			y += view_height;
+		}
+	}
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <limits>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "ui.h"
+#include "view_interface.h"
+
+namespace ui {
+/* layout class
+ * This class places views on the screen. The screen is divided into columns
+ * and every view is given a region inside one of them or a region spanning
+ * all of them at the top of the screen. Views are stacked in the order they
+ * were added and the last view of a column gets all of the remaining space.
+ *
+ * The regions are computed from the screen size and the heights reported by
+ * the views. They are only recomputed when the screen size or the height of
+ * a view changes.
+ */
+class layout {
+public:
+	/* all_columns - column index for views spanning every column */
+	static constexpr unsigned all_columns = std::numeric_limits<unsigned>::max();
+
+	/* region struct
+	 * This struct describes the part of the screen given to a view
+	 *
+	 * @view: the view drawn in the region
+	 * @from: top left corner of the region
+	 * @to: bottom right corner of the region
+	 */
+	struct region {
+		view_interface* view;
+		std::pair<unsigned, unsigned> from;
+		std::pair<unsigned, unsigned> to;
+	};
+
+	/* layout - ctor
+	 *
+	 * This ctor creates a layout with a single column
+	 */
+	layout();
+	/* layout - explicitly deleted copy ctor */
+	layout(const layout& rhs) = delete;
+
+	/* ~layout - explicitly defaulted dtor */
+	~layout() = default;
+
+	/* add_view - add a view to the layout
+	 * @view: pointer to the view
+	 * @column: index of the column or all_columns
+	 *
+	 * Adds the view to the bottom of the column. If the screen doesn't have
+	 * room for the column the view is added to the last column instead.
+	 */
+	void add_view(view_interface* view, unsigned column = 0);
+	/* invalidate - force the regions to be recomputed
+	 *
+	 * The regions are recomputed before the next draw
+	 */
+	void invalidate();
+	/* set_columns - set the number of columns
+	 * @columns: number of columns
+	 * @min_width: minimum width of a column
+	 *
+	 * Sets the number of columns the screen is divided into. If the screen
+	 * is too narrow to fit the columns with at least min_width characters
+	 * fewer columns are used. Throws std::invalid_argument if columns is 0.
+	 */
+	void set_columns(unsigned columns, unsigned min_width = 0);
+	/* set_screen_size - set the size of the screen
+	 * @size: pair containing the width and height of the screen
+	 */
+	void set_screen_size(std::pair<unsigned, unsigned> size);
+
+	/* draw - draw all of the views
+	 *
+	 * Recomputes the regions if needed and draws every view inside its
+	 * region
+	 */
+	void draw();
+	/* regions - get the regions
+	 *
+	 * Returns the regions computed for the views. The coordinates are
+	 * relative to the main window. Views without room on the screen don't
+	 * have a region.
+	 */
+	const std::vector<region>& regions();
+
+protected:
+	/* measure - query the heights of the views
+	 *
+	 * Returns true if any of the heights has changed since the last call
+	 */
+	bool measure();
+	/* place - compute the regions
+	 *
+	 * Computes the regions from the screen size and measured heights. The
+	 * windows for the regions are created on the next draw.
+	 */
+	void place();
+
+	unsigned columns_;
+	bool dirty_;
+	std::vector<unsigned> heights_;
+	std::unique_ptr<win> main_win_;
+	unsigned min_column_width_;
+	std::vector<region> regions_;
+	std::pair<unsigned, unsigned> screen_size_;
+	std::vector<std::pair<view_interface*, unsigned>> views_;
+	std::vector<std::unique_ptr<win>> windows_;
+};
+}
@@ -0,0 +1,143 @@
+#include "local_time.h"
+
+#include <ctime>
+
+/* seconds_per_day - length of a day without leap seconds */
+constexpr long long seconds_per_day = 24*60*60;
+
+/* civil_from_days - get the date of a day
+ * @days: days since 1970-01-01
+ * @time: the year, month, day and weekday are stored here
+ */
+static void civil_from_days(long long days, util::civil_time& time);
+/* days_from_civil - get the day of a date
+ * @year: the year
+ * @month: the month, 1 to 12
+ * @day: the day of the month
+ *
+ * Returns the number of days since 1970-01-01
+ */
+static long long days_from_civil(long long year, unsigned month, unsigned day);
+/* local_offset - get the offset of the local time zone
+ * @time: the time point
+ *
+ * Returns the offset from UTC in seconds at the time point
+ */
+static long local_offset(util::time_point time);
+
+util::time_point
+util::from_local(const civil_time& time)
+{
+	// The offset a day before and after the time is well defined, and they
+	// differ only if the offset changes close to the time
+	const time_point guess = from_utc(time);
+	const long before = local_offset(guess - std::chrono::hours(24));
+	const long after = local_offset(guess + std::chrono::hours(24));
+	const time_point with_before = guess - std::chrono::seconds(before);
+
+	if (before == after or local_offset(with_before) == before)
+		return with_before;
+
+	const time_point with_after = guess - std::chrono::seconds(after);
+
+	if (local_offset(with_after) == after)
+		return with_after;
+
+	// The time was skipped when the clocks were changed
+	return with_before;
+}
+
+util::time_point
+util::from_utc(const civil_time& time)
+{
+	const long long days = days_from_civil(time.year, time.month, time.day);
+
+	return time_point{std::chrono::seconds{days*seconds_per_day +
+					       time.hour*3600 +
+					       time.minute*60 +
+					       time.second}};
+}
+
+util::time_point
+util::now()
+{
+	return std::chrono::time_point_cast<std::chrono::seconds>(std::chrono::system_clock::now());
+}
+
+util::civil_time
+util::to_local(time_point time)
+{
+	return to_utc(time + std::chrono::seconds(local_offset(time)));
+}
+
+util::civil_time
+util::to_utc(time_point time)
+{
+	const long long secs = time.time_since_epoch().count();
+	long long days = secs / seconds_per_day;
+	long long rest = secs % seconds_per_day;
+
+	if (rest < 0) {
+		rest += seconds_per_day;
+		days--;
+	}
+
+	civil_time result;
+
+	civil_from_days(days, result);
+	result.hour = rest / 3600;
+	result.minute = rest % 3600 / 60;
+	result.second = rest % 60;
+
+	return result;
+}
+
+static void
+civil_from_days(long long days, util::civil_time& time)
+{
+	// 1970-01-01 was a Thursday
+	time.weekday = ((days % 7) + 11) % 7;
+
+	// Count from 0000-03-01 so that the leap day is the last day of the
+	// year and split the days into 400 year eras
+	days += 719468;
+
+	const long long era = (days >= 0 ? days : days - 146096) / 146097;
+	const unsigned day_of_era = days - era*146097;
+	const unsigned year_of_era = (day_of_era - day_of_era/1460 +
+				      day_of_era/36524 - day_of_era/146096) / 365;
+	const unsigned day_of_year = day_of_era - (365*year_of_era + year_of_era/4 -
+						   year_of_era/100);
+	const unsigned month_index = (5*day_of_year + 2) / 153;
+
+	time.day = day_of_year - (153*month_index + 2)/5 + 1;
+	time.month = month_index < 10 ? month_index + 3 : month_index - 9;
+	time.year = year_of_era + era*400 + (time.month <= 2);
+}
+
+static long long
+days_from_civil(long long year, unsigned month, unsigned day)
+{
+	year -= month <= 2;
+
+	const long long era = (year >= 0 ? year : year - 399) / 400;
+	const unsigned year_of_era = year - era*400;
+	const unsigned day_of_year = (153*(month > 2 ? month - 3 : month + 9) + 2)/5 +
+				     day - 1;
+	const unsigned day_of_era = year_of_era*365 + year_of_era/4 -
+				    year_of_era/100 + day_of_year;
+
+	return era*146097 + day_of_era - 719468;
+}
+
+static long
+local_offset(util::time_point time)
+{
+	const std::time_t t = time.time_since_epoch().count();
+	std::tm local;
+
+	if (not localtime_r(&t, &local))
+		return 0;
+
+	return local.tm_gmtoff;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <chrono>
+
+namespace util {
+	/* time_point - a point in time with a resolution of one second
+	 *
+	 * This is the only representation of time used by the events and the
+	 * views. It doesn't depend on the time zone, so comparing and
+	 * subtracting time points are plain integer operations. The time zone
+	 * only matters when a time point is converted to or from a civil_time.
+	 */
+	using time_point = std::chrono::time_point<std::chrono::system_clock,
+						   std::chrono::seconds>;
+
+	/* civil_time struct
+	 * This struct holds a date and a time of day as shown on a calendar
+	 *
+	 * @year: the year
+	 * @month: the month, 1 to 12
+	 * @day: the day of the month, 1 to 31
+	 * @hour: the hour, 0 to 23
+	 * @minute: the minute, 0 to 59
+	 * @second: the second, 0 to 59
+	 * @weekday: the day of the week, 0 being Sunday. Only set by the
+	 *           conversions to civil_time.
+	 */
+	struct civil_time {
+		int year;
+		unsigned month;
+		unsigned day;
+		unsigned hour;
+		unsigned minute;
+		unsigned second;
+		unsigned weekday;
+	};
+
+	/* from_local - convert a local time
+	 * @time: the local time
+	 *
+	 * Returns the time point shown as time in the local time zone. A time
+	 * that is skipped or repeated when the clocks are changed uses the
+	 * offset in effect before the change.
+	 */
+	time_point from_local(const civil_time& time);
+	/* from_utc - convert a time in UTC
+	 * @time: the time in UTC
+	 *
+	 * Returns the time point. Doesn't depend on the time zone.
+	 */
+	time_point from_utc(const civil_time& time);
+	/* now - get the current time
+	 *
+	 * Returns the current time rounded down to a second
+	 */
+	time_point now();
+	/* to_local - convert to local time
+	 * @time: the time point
+	 *
+	 * Returns the time point as shown in the local time zone
+	 */
+	civil_time to_local(time_point time);
+	/* to_utc - convert to UTC
+	 * @time: the time point
+	 *
+	 * Returns the time point as shown in UTC
+	 */
+	civil_time to_utc(time_point time);
+}
@@ -1,8 +1,11 @@
+#include <algorithm>
+#include <cctype>
 #include <chrono>
 #include <clocale>
-#include <codecvt>
 #include <csignal>
+#include <iostream>
 #include <list>
+#include <map>
 #include <regex>
 #include <thread>
 #include <tuple>
@@ -10,27 +13,33 @@
 #include <utility>
 #include <vector>
 
+#include "backend_registry.h"
+#include "db_connection.h"
 #include "event.h"
 #include "event_backend_interface.h"
 #include "event_model.h"
 #include "event_view.h"
-#include "google_calendar_backend.h"
-#include "parser.h"
+#include "layout.h"
 #include "pop_calendar_backend.h"
+#include "snapshot.h"
+#include "snapshot_backend.h"
 #include "status_view.h"
 #include "ui.h"
+#include "unicode.h"
 #include "utility.h"
 #include "view_interface.h"
 
 extern char version[];
 
-static bool quit = false;
+static volatile std::sig_atomic_t quit = false;
+static volatile std::sig_atomic_t resized = false;
 
 static void refresh_system_message(util::status_view& view);
 static void set_system_message(util::status_view& view,
 			       const std::wstring& msg,
 			       std::chrono::seconds timeout);
-static void print_help(const char* name);
+static void print_help(const char* name,
+		       const events::backend_registry& registry);
 static void print_version();
 static void signal_handler(int signo);
 
@@ -44,106 +53,151 @@ int main(int argc, const char** argv)
 {
 	using namespace std::chrono_literals;
 
-	// Create views and add them to the controllers list
-	std::list<view_interface*> views;
-	
+	// Create the status view. The event views are created after the
+	// commandline is parsed as their count depends on it
 	util::status_view status;
-	views.push_back(&status);
 
-	events::event_view calendar_view;
-	views.push_back(&calendar_view);
+	unsigned columns = 1;
+	unsigned min_column_width = 0;
+	auto paging_mode = events::event_view::paging::off;
+	std::chrono::seconds paging_interval{0};
 
 	// Create the event model and register the backends parsed from commandline to it
+	events::backend_registry registry;
+	events::add_default_backends(registry);
+
 	std::vector<std::pair<std::string, std::vector<std::string>>> params;
 
 	try {
 		params = util::parse_commandline(argc, argv);
 	} catch (const std::exception& e) {
 		std::cout << "Failed to parse arguments\n\n";
-		print_help(argv[0]);
+		print_help(argv[0], registry);
 		return -1;
 	}
 
 	events::event_model calendar_model;
-	std::list<std::shared_ptr<events::event_backend_interface>> backends;
+	std::list<events::backend_registry::created> backends;
+	std::string cache_dir;
+	std::string dump_path;
 
 	for (const auto [name, values] : params) {
 		if (name == "help") {
-			print_help(argv[0]);
+			print_help(argv[0], registry);
 			return 0;
 		} else if (name == "version") {
 			print_version();
 			return 0;
 		}
 
-		if (name == "google-api") {
-			if (values.size() == 2) {
-				auto backend = std::make_shared<events::google_calendar_backend>();
-
-				backend->set_id(values[0]);
-				backend->set_key(values[1]);
-
-				backends.emplace_back(std::move(backend));
-				calendar_model.add_source(backends.back());
-			} else if (values.size() == 4) {
-				auto backend = std::make_shared<events::google_calendar_backend>();
-
-				backend->set_id(values[0]);
-				backend->set_key(values[1]);
+		if (registry.contains(name)) {
+			try {
+				backends.push_back(registry.create(name, values));
+			} catch (const std::exception& e) {
+				std::cout << e.what() << "\n\n";
+				print_help(argv[0], registry);
+				return -1;
+			}
+		} else if (name == "logo") {
+			if (values.size() == 0) {
+				status.set_logo("/usr/local/share/info-tv/logo.ascii");
+			} else if (values.size() == 1) {
+				status.set_logo(values[0]);
+			} else {
+				std::cout << "Wrong amount of arguments for --logo\n\n";
+				print_help(argv[0], registry);
+				return -1;
+			}
+		} else if (name == "cache") {
+			if (values.size() == 1) {
+				cache_dir = values[0];
+			} else {
+				std::cout << "Wrong amount of arguments for --cache\n\n";
+				print_help(argv[0], registry);
+				return -1;
+			}
+		} else if (name == "conflicts") {
+			if (values.size() == 0) {
+				calendar_model.set_conflict_hilight(true);
+			} else {
+				std::cout << "Wrong amount of arguments for --conflicts\n\n";
+				print_help(argv[0], registry);
+				return -1;
+			}
+		} else if (name == "dump-events") {
+			if (values.size() == 1) {
+				// Subscribers may show the descriptions
+				dump_path = values[0];
+				calendar_model.set_keep_descriptions(true);
+			} else {
+				std::cout << "Wrong amount of arguments for --dump-events\n\n";
+				print_help(argv[0], registry);
+				return -1;
+			}
+		} else if (name == "columns") {
+			if (values.size() == 1 or values.size() == 2) {
+				int count;
+				int width;
 
 				try {
-					backend->set_cooldown(std::stoi(values[2]));
-					backend->set_error_cooldown(std::stoi(values[3]));
+					count = std::stoi(values[0]);
+					width = values.size() == 2 ?
+						std::stoi(values[1]) : 0;
 				} catch (const std::exception& e) {
-					std::cout << "Invalid cooldown argument for --google-api\n\n";
-					print_help(argv[0]);
+					count = -1;
+					width = -1;
+				}
+
+				if (count <= 0 or width < 0) {
+					std::cout << "Invalid argument for --columns\n\n";
+					print_help(argv[0], registry);
 					return -1;
 				}
 
-				backends.emplace_back(std::move(backend));
-				calendar_model.add_source(backends.back());
+				columns = count;
+				min_column_width = width;
 			} else {
-				std::cout << "Wrong amount of arguments for --google-api\n\n";
-				print_help(argv[0]);
+				std::cout << "Wrong amount of arguments for --columns\n\n";
+				print_help(argv[0], registry);
 				return -1;
 			}
-		} else if (name == "pop-api") {
-			if (values.size() == 1) {
-				auto backend = std::make_shared<events::pop_calendar_backend>();
-
-				backend->set_url(values[0]);
+		} else if (name == "paging") {
+			if (values.size() == 2) {
+				events::event_view::paging mode;
 
-				backends.push_back(std::move(backend));
-				calendar_model.add_source(backends.back());
-			} else if (values.size() == 3) {
-				auto backend = std::make_shared<events::pop_calendar_backend>();
+				if (values[0] == "page") {
+					mode = events::event_view::paging::page;
+				} else if (values[0] == "scroll") {
+					mode = events::event_view::paging::scroll;
+				} else {
+					std::cout << "Unknown mode for --paging: "
+						  << values[0]
+						  << "\n\n";
+					print_help(argv[0], registry);
+					return -1;
+				}
 
-				backend->set_url(values[0]);
+				int interval;
 
 				try {
-					backend->set_cooldown(std::stoi(values[1]));
-					backend->set_error_cooldown(std::stoi(values[2]));
+					interval = std::stoi(values[1]);
 				} catch (const std::exception& e) {
-					std::cout << "Invalid cooldown argument for --pop-api\n\n";
-					print_help(argv[0]);
+					interval = -1;
+				}
+
+				if (interval <= 0) {
+					std::cout << "Invalid interval for --paging: "
+						  << values[1]
+						  << "\n\n";
+					print_help(argv[0], registry);
 					return -1;
 				}
 
-				backends.push_back(std::move(backend));
-				calendar_model.add_source(backends.back());
+				paging_mode = mode;
+				paging_interval = std::chrono::seconds(interval);
 			} else {
-				std::cout << "Wrong amount of arguments for --pop-api\n\n";
-				print_help(argv[0]);
-				return -1;
-			}
-		} else if (name == "logo") {
-			if (values.size() == 0) {
-				status.set_logo("/usr/local/share/info-tv/logo.ascii");
-			} else if (values.size() == 1) {
-				status.set_logo(values[0]);
-			} else {
-				std::cout << "Wrong amount of arguments for --logo\n\n";
-				print_help(argv[0]);
+				std::cout << "Wrong amount of arguments for --paging\n\n";
+				print_help(argv[0], registry);
 				return -1;
 			}
 		} else if (name == "hilight") {
@@ -156,7 +210,7 @@ int main(int argc, const char** argv)
 					std::cout << "Invalid argument for --hilight: "
 						  << values[0]
 						  << "\n\n";
-					print_help(argv[0]);
+					print_help(argv[0], registry);
 					return -1;
 				}
 
@@ -164,7 +218,7 @@ int main(int argc, const char** argv)
 					std::cout << "Invalid argument for --hilight: "
 						  << values[0]
 						  << "\n\n";
-					print_help(argv[0]);
+					print_help(argv[0], registry);
 					return -1;
 				}
 
@@ -173,8 +227,17 @@ int main(int argc, const char** argv)
 				if (values[0] == "search") {
 					std::basic_regex<wchar_t> r;
 
-					std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-					std::wstring regex_expr = converter.from_bytes(values[2]);
+					std::wstring regex_expr;
+
+					try {
+						regex_expr = util::from_utf8(values[2]);
+					} catch (const std::range_error& e) {
+						std::cout << "Invalid utf-8 in --hilight search: "
+							  << values[2]
+							  << "\n\n";
+						print_help(argv[0], registry);
+						return -1;
+					}
 
 					try {
 						r = std::basic_regex<wchar_t>(regex_expr,
@@ -187,7 +250,7 @@ int main(int argc, const char** argv)
 							  << " For: "
 							  << values[2]
 							  << "\n\n";
-						print_help(argv[0]);
+						print_help(argv[0], registry);
 						return -1;
 					}
 
@@ -207,7 +270,7 @@ int main(int argc, const char** argv)
 						std::cout << "Unknown target for --hilight search: "
 							  << values[1]
 							  << "!\n\n";
-						print_help(argv[0]);
+						print_help(argv[0], registry);
 						return -1;
 					}
 
@@ -216,53 +279,132 @@ int main(int argc, const char** argv)
 					std::cout << "Unknown argument for --hilight: "
 						  << values[0]
 						  << "\n\n";
-					print_help(argv[0]);
+					print_help(argv[0], registry);
 					return -1;
 				}
 			} else {
 				std::cout << "Wrong amount of arguments for --highlight\n\n";
-				print_help(argv[0]);
+				print_help(argv[0], registry);
 				return -1;
 			}
 		} else {
 			std::cout << "Unknown option '"
 				  << name
 				  << "'.\n\n";
-			print_help(argv[0]);
+			print_help(argv[0], registry);
 			return -1;
 		}
 	}
 
-	calendar_view.set_model(&calendar_model);
+	// Register the backends in the order they were given. With a cache
+	// directory the events of each backend are kept in a snapshot so that
+	// they can be shown right after a restart
+	//
+	// Backends with the same key request the same data. Only the first
+	// one is used, the model gives it the indices of all of them. Since
+	// the others are never updated their settings must not differ
+	std::map<std::string, events::backend_registry::created> registered;
+
+	for (auto& [key, backend, remote, settings] : backends) {
+		if (auto it = registered.find(key); it != registered.end()) {
+			if (it->second.settings != settings) {
+				std::cout << "The same calendar is given twice with "
+					     "different options: "
+					  << it->second.settings
+					  << " and "
+					  << settings
+					  << "\n\n";
+				print_help(argv[0], registry);
+				return -1;
+			}
+
+			calendar_model.add_source(it->second.backend);
+			continue;
+		}
+
+		// Local backends already read their data from the disk
+		if (not cache_dir.empty() and remote) {
+			// The calendar files are cached as well so that unchanged
+			// ones are neither downloaded nor parsed again
+			if (auto pop = std::dynamic_pointer_cast<events::pop_calendar_backend>(backend))
+				pop->set_cache_dir(cache_dir);
+
+			backend = std::make_shared<events::snapshot_backend>(
+				  backend,
+				  key,
+				  events::snapshot_path(cache_dir, key));
+		}
+
+		registered.emplace(key, events::backend_registry::created{
+					   key, backend, remote, settings});
+		calendar_model.add_source(backend);
+	}
+
+	// Place the status view on top of the event views. Each event view
+	// continues from where the previous column ended
+	ui::layout layout;
+	layout.set_columns(columns, min_column_width);
+	layout.add_view(&status, ui::layout::all_columns);
+
+	std::vector<std::unique_ptr<events::event_view>> calendar_views;
+
+	for (unsigned i = 0; i < columns; i++) {
+		auto view = std::make_unique<events::event_view>();
+
+		view->set_model(&calendar_model);
+
+		if (calendar_views.empty())
+			view->set_paging(paging_mode, paging_interval);
+		else
+			view->continue_from(calendar_views.back().get());
+
+		layout.add_view(view.get(), i);
+		calendar_views.push_back(std::move(view));
+	}
 
 	// Setup curses and signal handler
 	ui::screen_init();
 
 	std::signal(SIGINT, signal_handler);
+	std::signal(SIGWINCH, signal_handler);
 
-	unsigned screen_width, screen_height;
-	std::tie(screen_width, screen_height) = ui::screen_size();
+	layout.set_screen_size(ui::screen_size());
+
+	unsigned long dumped_revision = calendar_model.revision();
 
 	do {
 		auto start = std::chrono::steady_clock::now();
 
-		ui::clear();
+		// The screen size is only queried after the terminal has been
+		// resized. This also makes the layout recompute the regions
+		if (resized) {
+			resized = false;
+			layout.set_screen_size(ui::screen_resize());
+		}
 
 		bool new_events = calendar_model.update();
 		if (new_events)
 			set_system_message(status, L"Events updated!", 60s);
 
-		status.set_system_time(second_clock::local_time());
+		status.set_system_time(util::now());
 		refresh_system_message(status);
 
-		// Draw everything
-		ui::win main_win{{2, 1},
-				 {screen_width - 2, screen_height - 1}};
-	
-		for (auto view : views)
-			view->draw(main_win);
+		// Publish the merged events for other processes whenever they
+		// change. The snapshot can be read without decoding it
+		if (not dump_path.empty() and
+		    calendar_model.revision() != dumped_revision) {
+			dumped_revision = calendar_model.revision();
+
+			try {
+				events::save_snapshot(dump_path, "info-tv",
+						      calendar_model.events());
+			} catch (const std::exception& e) {
+				set_system_message(status, L"Failed to dump events!", 60s);
+			}
+		}
 
-		main_win.draw();
+		// Draw everything
+		layout.draw();
 
 		auto end = std::chrono::steady_clock::now();
 		auto loop_duration = end - start;
@@ -294,29 +436,42 @@ static void set_system_message(util::status_view& view,
 	system_messages.set_time = std::chrono::steady_clock::now();
 }
 
-static void print_help(const char* name)
+static void print_help(const char* name,
+		       const events::backend_registry& registry)
 {
 	std::cout << "Usage:\n"
 		  << "  " << name << " [ --help | --version ]\n"
 		  << "  " << name << " [ options ]\n\n"
-		  << "Options:\n"
-		  << "  --pop-api <url> [ <cd> <ecd> ]\n"
-		  << "                         Add a POP backend with the <url> pointing to the ics\n"
-		  << "                         resource. <cd> is the cooldown period in seconds and\n"
-		  << "                         <ecd> is the cooldown period used if the connection\n"
-		  << "                         to server failed.\n"
-		  << "  --google-api <id> <key> [ <cd> <ecd> ]\n"
-		  << "                         Add a Google backend with the calendar id <id> and API\n"
-		  << "                         key <key>. <cd> is the cooldown period in seconds\n"
-		  << "                         and <ecd> is the cooldown period used if the connection\n"
-		  << "                         to server failed.\n"
+		  << "Options:\n";
+
+	for (const auto& entry : registry.entries())
+		std::cout << entry.help;
+
+	std::cout
 		  << "  --hilight <source> | search <target> <regex>\n"
 		  << "                         Highlight events that are either from the source number\n"
 		  << "                         <source> (indexing starts from 0) or that match the\n"
 		  << "                         <regex> in <target>. <target> can be any one of these:\n"
 		  << "                         'name', 'description', 'location' or 'all'.\n"
+		  << "  --conflicts            Highlight the location of events that overlap another\n"
+		  << "                         event at the same location.\n"
+		  << "  --cache <dir>          Keep the events of every backend in <dir> and show\n"
+		  << "                         them right after a restart while the backends are\n"
+		  << "                         being updated. POP calendars are only downloaded\n"
+		  << "                         again if they have changed.\n"
+		  << "  --dump-events <path>   Write the shown events to a snapshot file at <path>\n"
+		  << "                         every time they change.\n"
+		  << "  --columns <count> [ <width> ]\n"
+		  << "                         Show the events in <count> columns. If the screen is\n"
+		  << "                         too narrow to fit columns that are at least <width>\n"
+		  << "                         characters wide fewer columns are used.\n"
 		  << "  --logo <path>          Path to a text file containing the ascii graphic logo\n"
-		  << "                         to display at the top of the screen.\n";
+		  << "                         to display at the top of the screen.\n"
+		  << "  --paging <mode> <interval>\n"
+		  << "                         Cycle through events that don't fit on the screen.\n"
+		  << "                         <mode> is either 'page' to flip a screenful at a time\n"
+		  << "                         or 'scroll' to move one event at a time. <interval>\n"
+		  << "                         is the time in seconds between the moves.\n";
 }
 
 static void print_version()
@@ -328,6 +483,11 @@ static void print_version()
 
 static void signal_handler(int signo)
 {
-	if (signo == SIGINT)
+	if (signo == SIGINT) {
 		quit = true;
+		// Don't wait for a hung server before exiting
+		events::db_connection::cancel_all();
+	} else if (signo == SIGWINCH) {
+		resized = true;
+	}
 }
@@ -1,91 +1,217 @@
 #include "parser.h"
 
-#include <codecvt>
+#include <algorithm>
 #include <cstring>
-#include <locale>
+#include <exception>
+#include <optional>
+#include <string_view>
+#include <thread>
+#include <vector>
 
 #include <nlohmann/json.hpp>
 
 #include "event.h"
 #include "icalendar.h"
+#include "timestamp.h"
+#include "unicode.h"
 
-#include <boost/date_time.hpp>
-
-using boost::posix_time::time_from_string;
-using boost::posix_time::second_clock;
-using boost::gregorian::from_string;
-
-/* parse_datetime - parse date and time from the json provided by the Google
- * API
- * @src: string containing the date and time
+/* min_part_size - smallest amount of icalendar data parsed by a thread
+ *
+ * Below this starting a thread costs more than it saves.
  */
-static ptime parse_datetime(const std::string& src)
-{
-	auto temp{src};
-
-	temp.replace(temp.find_first_of('T'), 1, 1, ' ');
-	temp.erase(temp.find_first_of('+'));
-	
-	try {
-		return time_from_string(temp);
-	} catch (...) {
-		throw std::runtime_error{"failed to parse datetime"};
-	}
-}
+static constexpr std::size_t min_part_size = 256*1024;
+
+/* calendar_part struct
+ * This struct holds what was read from a part of a VCALENDAR.
+ *
+ * @events: the events in the order they were read
+ * @product: the first PRODID of the part
+ * @version: the first VERSION of the part
+ * @ended: true if the part contains the end of the VCALENDAR
+ * @skipped: number of malformed events and lines skipped
+ * @error: exception thrown while reading the part
+ */
+struct calendar_part {
+	std::list<events::event> events;
+	std::string_view product;
+	std::string_view version;
+	bool ended = false;
+	std::size_t skipped = 0;
+	std::exception_ptr error;
+};
+
+/* vevent struct
+ * This struct holds the properties of a VEVENT used by events_from_ics. The
+ * views refer to the icalendar data.
+ */
+struct vevent {
+	std::string_view description;
+	std::string_view id;
+	std::string_view location;
+	std::string_view name;
+	std::string_view status;
+};
+
+/* parse_time - parse a time and report errors for a field
+ * @src: the timestamp
+ * @what: description of the field used in the error message
+ */
+static util::time_point parse_time(std::string_view src, const char* what);
+/* read_json_event - read an event from Google json
+ * @event: the json object of the event
+ * @window: the events to return
+ * @dst: list the event is added to
+ *
+ * The event is added only if it is confirmed and in the window. Throws if
+ * the event is malformed, in which case nothing is added.
+ */
+static void read_json_event(const nlohmann::json& event,
+			    const events::parser::time_window& window,
+			    std::list<events::event>& dst);
+/* read_calendar - read the contents of a VCALENDAR
+ * @reader: reader positioned inside the VCALENDAR
+ * @window: the events to return
+ * @dst: the part to fill
+ *
+ * Reads until the end of the VCALENDAR or the data.
+ */
+static void read_calendar(icalendar::reader& reader,
+			  const events::parser::time_window& window,
+			  calendar_part& dst);
+/* read_vevent - read the properties of a VEVENT
+ * @reader: reader positioned after the BEGIN line of the VEVENT
+ * @window: the events to return
+ * @dst: list the event is added to
+ *
+ * Reads the VEVENT up to its END line. The event is added only if it is
+ * confirmed and in the window. Otherwise the rest of it is skipped as soon
+ * as that is known.
+ *
+ * Returns false if the event is malformed, in which case nothing is added.
+ */
+static bool read_vevent(icalendar::reader& reader,
+			const events::parser::time_window& window,
+			std::list<events::event>& dst);
+/* split_components - split icalendar data for parallel parsing
+ * @src: contents of a VCALENDAR
+ * @count: the number of parts wanted
+ *
+ * Returns at most count parts of about equal size. Every part but the first
+ * starts with a BEGIN:VEVENT line, so no component is split.
+ */
+static std::vector<std::string_view> split_components(std::string_view src,
+						      unsigned count);
+/* text - decode a text value of an icalendar property
+ * @value: the value
+ */
+static std::wstring text(std::string_view value);
+/* unescape - unescape a text value of an icalendar property
+ * @value: the value
+ *
+ * Returns the value in utf-8 without decoding it.
+ */
+static std::string unescape(std::string_view value);
 
 std::list<events::event>
-events::parser::events_from_ics(const std::string& ics_str)
+events::parser::events_from_ics(const std::string& ics_str,
+				const time_window& window,
+				unsigned threads,
+				std::size_t* skipped)
 {
-	using boost::posix_time::from_iso_string;
+	icalendar::reader reader{ics_str};
+	icalendar::content_line line;
+
+	do {
+		if (not reader.next(line))
+			throw std::runtime_error{"failed to find a root node"};
+	} while (line.name != "BEGIN");
+
+	if (line.value != "VCALENDAR")
+		throw std::runtime_error{"root node is not VCALENDAR"};
+
+	const auto body = reader.rest();
+	const auto count = std::max<std::size_t>(1, std::min<std::size_t>(threads, body.size() / min_part_size));
+	const auto sources = split_components(body, count);
+	std::vector<calendar_part> parts(sources.size());
+	std::vector<std::thread> workers;
+
+	const auto read_part = [&window, &sources, &parts](std::size_t i) {
+		try {
+			icalendar::reader part_reader{sources[i]};
+
+			read_calendar(part_reader, window, parts[i]);
+		} catch (...) {
+			parts[i].error = std::current_exception();
+		}
+	};
+
+	// The calling thread reads the first part
+	for (std::size_t i = 1; i < sources.size(); i++)
+		workers.emplace_back(read_part, i);
 
+	read_part(0);
+
+	for (auto& worker : workers)
+		worker.join();
+
+	// The parts are merged in order, so the first error and the first
+	// properties are the ones a single thread would have found
 	std::list<events::event> event_list;
-	std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
+	std::string_view product;
+	std::string_view version;
+	std::size_t skipped_events = 0;
+
+	for (auto& part : parts) {
+		if (part.error)
+			std::rethrow_exception(part.error);
+
+		event_list.splice(event_list.end(), part.events);
+		skipped_events += part.skipped;
 
-	icalendar::node root = icalendar::parse(ics_str);
+		if (product.empty())
+			product = part.product;
+		if (version.empty())
+			version = part.version;
 
-	if (root["VERSION"] != "2.0")
+		if (part.ended)
+			break;
+	}
+
+	if (version != "2.0")
 		throw std::runtime_error{"root node has wrong icalendar version"};
 
-	if (root["PRODID"] != "TUT.FI//POP-CALENDARSERVICE_V1.0//FI")
+	if (product != "TUT.FI//POP-CALENDARSERVICE_V1.0//FI")
 		throw std::runtime_error{"wrong product id"};
 
-	for (auto event : root.subnode("VEVENT")) {
-		if (event["STATUS"] != "CONFIRMED")
-			continue;
+	if (skipped)
+		*skipped = skipped_events;
 
-		// Since POP provides us with events that are 2 month old we need to only add
-		// the once that are still relevant at the moment
-		if (from_iso_string(event["DTEND;TZID=Europe/Helsinki"]) < second_clock::local_time())
-			continue;
+	return event_list;
+}
 
-		const std::string name = event["SUMMARY"];
-		event_list.emplace_back(events::event{converter.from_bytes(name.c_str()),
-					from_iso_string(event["DTSTART;TZID=Europe/Helsinki"]),
-					from_iso_string(event["DTEND;TZID=Europe/Helsinki"])});
-		const std::string location = event["LOCATION"];
-		const std::string id = event["UID"];
-		const std::wstring description = converter.from_bytes(event["DESCRIPTION"].c_str());
-		
-		if (not location.empty())
-			event_list.back().set_location(converter.from_bytes(location.c_str()));
-		if (not id.empty())
-			event_list.back().set_id(id);
-
-		if (not description.empty())
-			event_list.back().set_description(description);
-	}
+std::list<events::event>
+events::parser::events_from_feed(const std::string& data,
+				 const time_window& window,
+				 unsigned threads,
+				 std::size_t* skipped)
+{
+	const auto first = data.find_first_not_of(" \t\r\n");
 
-	return event_list;
+	if (first != std::string::npos and data[first] == '{')
+		return events_from_json(data, window, skipped);
+
+	return events_from_ics(data, window, threads, skipped);
 }
 
 std::list<events::event>
-events::parser::events_from_json(const std::string& json_str)
+events::parser::events_from_json(const std::string& json_str,
+				 const time_window& window,
+				 std::size_t* skipped)
 {
 	using json = nlohmann::json;
 
-	std::wstring_convert<std::codecvt_utf8_utf16<wchar_t>> converter;
-
 	json data;
+	std::size_t skipped_events = 0;
 
 	try {
 		data = json::parse(json_str);
@@ -102,108 +228,306 @@ events::parser::events_from_json(const std::string& json_str)
 	
 	auto item_it = data.find("items");
 	if (item_it != data.end()) {
-		auto events = *item_it;
+		const auto& events = *item_it;
 		std::list<event> event_list;
 
-		for (auto event : events) {
-			std::string name;
-			std::string location;
-			std::string id;
-			std::wstring description;
-			ptime start;
-			ptime end;
-
-			auto iter = event.find("kind");
-			if (iter == event.end())
-				throw std::runtime_error{"can't find key \"kind\" from event"};
-			if (*iter != "calendar#event")
-				throw std::runtime_error{"event: key \"kind\" has and unsupported value"};
-
-			iter = event.find("status");
-			if (iter == event.end())
-				throw std::runtime_error{"can't find key \"status\" from event"};
-			if (*iter == "tentative") {
-				continue;
-			} else if (*iter == "confirmed") {
-				iter = event.find("summary");
-				if (iter == event.end())
-					throw std::runtime_error{"can't find key \"summary\" from event"};
-				else
-					name = *iter;
-
-				iter = event.find("location");
-				if (iter != event.end())
-					location = *iter;
-
-				iter = event.find("iCalUID");
-				if (iter != event.end())
-					id = *iter;
-
-				iter = event.find("description");
-				if (iter != event.end())
-					description = converter.from_bytes((*iter).get<std::string>().c_str());
-
-				iter = event.find("start");
-				if (iter == event.end())
-					throw std::runtime_error{"can' find key \"start\" from event"};
-
-				auto start_time = *iter;
-
-				iter = start_time.find("dateTime");
-				if (iter == start_time.end()) {
-					iter = start_time.find("date");
-					if (iter == start_time.end()) {
-						throw std::runtime_error{"can't find \"dateTime\" or \"date\" from event start time"};
-					} else {
-						try {
-							start = ptime{from_string(*iter)};
-						} catch (...) {
-							throw std::runtime_error{"failed to parse start date"};
-						}
-					}
-				} else {
-					start = parse_datetime(*iter);
-				}
+		for (const auto& event : events) {
+			// A malformed event is skipped instead of failing the
+			// whole feed
+			try {
+				read_json_event(event, window, event_list);
+			} catch (const std::exception&) {
+				skipped_events++;
+			}
+		}
 
-				iter = event.find("end");
-				if (iter == event.end())
-					throw std::runtime_error{"can't find key \"end\" from event"};
-
-				auto end_time = *iter;
-
-				iter = end_time.find("dateTime");
-				if (iter == end_time.end()) {
-					iter = end_time.find("date");
-					if (iter == end_time.end()) {
-						throw std::runtime_error{"can't find \"dateTime\" or \"date\" from event end time"};
-					} else {
-						try {
-							end = ptime{from_string(*iter)};
-						} catch (...) {
-							throw std::runtime_error{"failed to parse end date"};
-						}
-						
-					}
-				} else {
-					end = parse_datetime(*iter);
-				}
+		if (skipped)
+			*skipped = skipped_events;
+
+		return event_list;
+	} else {
+		if (skipped)
+			*skipped = 0;
+
+		return {};
+	}
+}
 
-				event_list.emplace_back(events::event{converter.from_bytes(name.c_str()), start, end});
+static util::time_point
+parse_time(std::string_view src, const char* what)
+{
+	try {
+		return events::parser::to_time_point(src);
+	} catch (...) {
+		throw std::runtime_error{std::string{"failed to parse "} + what};
+	}
+}
+
+static void
+read_json_event(const nlohmann::json& event,
+		const events::parser::time_window& window,
+		std::list<events::event>& dst)
+{
+	util::time_point start;
+	util::time_point end;
+
+	auto iter = event.find("kind");
+	if (iter == event.end())
+		throw std::runtime_error{"can't find key \"kind\" from event"};
+	if (*iter != "calendar#event")
+		throw std::runtime_error{"event: key \"kind\" has and unsupported value"};
+
+	iter = event.find("status");
+	if (iter == event.end())
+		throw std::runtime_error{"can't find key \"status\" from event"};
+	if (*iter == "tentative") {
+		return;
+	} else if (*iter == "confirmed") {
+		const auto name_it = event.find("summary");
+		if (name_it == event.end())
+			throw std::runtime_error{"can't find key \"summary\" from event"};
+
+		iter = event.find("start");
+		if (iter == event.end())
+			throw std::runtime_error{"can' find key \"start\" from event"};
+
+		const auto& start_time = *iter;
+
+		iter = start_time.find("dateTime");
+		if (iter == start_time.end()) {
+			iter = start_time.find("date");
+			if (iter == start_time.end()) {
+				throw std::runtime_error{"can't find \"dateTime\" or \"date\" from event start time"};
+			} else {
+				start = parse_time(iter->get_ref<const std::string&>(), "start date");
+			}
+		} else {
+			start = parse_time(iter->get_ref<const std::string&>(), "start time");
+		}
 
-				if (not location.empty())
-					event_list.back().set_location(converter.from_bytes(location.c_str()));
-				if (not id.empty())
-					event_list.back().set_id(id);
+		iter = event.find("end");
+		if (iter == event.end())
+			throw std::runtime_error{"can't find key \"end\" from event"};
 
-				if (not description.empty())
-					event_list.back().set_description(description);
+		const auto& end_time = *iter;
+
+		iter = end_time.find("dateTime");
+		if (iter == end_time.end()) {
+			iter = end_time.find("date");
+			if (iter == end_time.end()) {
+				throw std::runtime_error{"can't find \"dateTime\" or \"date\" from event end time"};
 			} else {
-				throw std::runtime_error{"event key \"status\" has an unkown value"};
+				end = parse_time(iter->get_ref<const std::string&>(), "end date");
 			}
+		} else {
+			end = parse_time(iter->get_ref<const std::string&>(), "end time");
 		}
 
-		return event_list;
+		// The strings are only decoded for the events that are
+		// returned
+		if (not window.contains(start, end))
+			return;
+
+		// The event is added only after all of its fields have been
+		// read, so a bad field doesn't leave half of an event behind
+		events::event result{util::from_utf8(name_it->get_ref<const std::string&>()),
+				     start,
+				     end};
+
+		iter = event.find("location");
+		if (iter != event.end() and not iter->get_ref<const std::string&>().empty())
+			result.set_location(util::from_utf8(iter->get_ref<const std::string&>()));
+
+		iter = event.find("iCalUID");
+		if (iter != event.end() and not iter->get_ref<const std::string&>().empty())
+			result.set_id(iter->get_ref<const std::string&>());
+
+		iter = event.find("description");
+		if (iter != event.end() and not iter->get_ref<const std::string&>().empty())
+			result.set_description(iter->get_ref<const std::string&>());
+
+		dst.push_back(std::move(result));
 	} else {
-		return {};
+		throw std::runtime_error{"event key \"status\" has an unkown value"};
+	}
+}
+
+static void
+read_calendar(icalendar::reader& reader,
+	      const events::parser::time_window& window,
+	      calendar_part& dst)
+{
+	icalendar::content_line line;
+
+	for (;;) {
+		// A line that is not a property is skipped like a malformed
+		// event, the reader has already moved past it
+		try {
+			if (not reader.next(line))
+				break;
+		} catch (const std::runtime_error&) {
+			dst.skipped++;
+			continue;
+		}
+
+		if (line.name == "END" and line.value == "VCALENDAR") {
+			dst.ended = true;
+			break;
+		}
+
+		if (line.name == "BEGIN") {
+			if (line.value == "VEVENT") {
+				if (not read_vevent(reader, window, dst.events))
+					dst.skipped++;
+			} else {
+				reader.skip(line.value);
+			}
+		} else if (line.name == "VERSION" and dst.version.empty()) {
+			dst.version = line.value;
+		} else if (line.name == "PRODID" and dst.product.empty()) {
+			dst.product = line.value;
+		}
+	}
+}
+
+static bool
+read_vevent(icalendar::reader& reader,
+	    const events::parser::time_window& window,
+	    std::list<events::event>& dst)
+{
+	// Since POP provides us with events that are 2 month old most of the
+	// events are skipped right after their times have been read
+	vevent e;
+	std::optional<util::time_point> start;
+	std::optional<util::time_point> end;
+	icalendar::content_line line;
+
+	try {
+		while (reader.next(line)) {
+			if (line.name == "END" and line.value == "VEVENT")
+				break;
+
+			if (line.name == "BEGIN") {
+				reader.skip(line.value);
+				continue;
+			}
+
+			// Only the first occurrence of a property counts
+			if (line.name == "STATUS" and e.status.empty()) {
+				e.status = line.value;
+
+				if (e.status != "CONFIRMED") {
+					reader.skip("VEVENT");
+					return true;
+				}
+			} else if (line.name == "DTSTART;TZID=Europe/Helsinki" and not start) {
+				start = parse_time(line.value, "start time");
+			} else if (line.name == "DTEND;TZID=Europe/Helsinki" and not end) {
+				end = parse_time(line.value, "end time");
+			} else if (line.name == "SUMMARY" and e.name.empty()) {
+				e.name = line.value;
+			} else if (line.name == "LOCATION" and e.location.empty()) {
+				e.location = line.value;
+			} else if (line.name == "UID" and e.id.empty()) {
+				e.id = line.value;
+			} else if (line.name == "DESCRIPTION" and e.description.empty()) {
+				e.description = line.value;
+			} else {
+				continue;
+			}
+
+			if ((end and *end < window.begin) or (start and *start >= window.end)) {
+				reader.skip("VEVENT");
+				return true;
+			}
+		}
+	} catch (const std::exception&) {
+		// The line that failed has been read, so the rest of the event
+		// can be skipped
+		reader.skip("VEVENT");
+		return false;
 	}
+
+	if (e.status != "CONFIRMED")
+		return true;
+
+	if (not start or not end)
+		return false;
+
+	try {
+		events::event result{text(e.name), *start, *end};
+
+		if (not e.location.empty())
+			result.set_location(text(e.location));
+		if (not e.id.empty())
+			result.set_id(std::string{e.id});
+		if (not e.description.empty())
+			result.set_description(unescape(e.description));
+
+		dst.push_back(std::move(result));
+	} catch (const std::exception&) {
+		return false;
+	}
+
+	return true;
+}
+
+static std::vector<std::string_view>
+split_components(std::string_view src, unsigned count)
+{
+	constexpr std::string_view begin = "\nBEGIN:VEVENT";
+
+	std::vector<std::string_view> parts;
+	std::size_t part_start = 0;
+
+	for (unsigned i = 1; i < count; i++) {
+		auto pos = std::max(part_start, src.size() / count * i);
+
+		// The line has to be exactly BEGIN:VEVENT
+		while ((pos = src.find(begin, pos)) != std::string_view::npos) {
+			const auto next = pos + begin.size();
+
+			if (next == src.size() or src[next] == '\r' or src[next] == '\n')
+				break;
+
+			pos = next;
+		}
+
+		if (pos == std::string_view::npos)
+			break;
+
+		parts.push_back(src.substr(part_start, pos + 1 - part_start));
+		part_start = pos + 1;
+	}
+
+	parts.push_back(src.substr(part_start));
+
+	return parts;
+}
+
+static std::wstring
+text(std::string_view value)
+{
+	// Commas are escaped in text values
+	if (value.find("\\,") == std::string_view::npos)
+		return util::from_utf8(value);
+
+	return util::from_utf8(unescape(value));
+}
+
+static std::string
+unescape(std::string_view value)
+{
+	std::string unescaped;
+
+	unescaped.reserve(value.size());
+
+	for (std::size_t i = 0; i < value.size(); i++) {
+		if (value[i] == '\\' and i + 1 < value.size() and value[i + 1] == ',')
+			i++;
+
+		unescaped.push_back(value[i]);
+	}
+
+	return unescaped;
 }
@@ -5,22 +5,79 @@
 #include <string>
 
 #include "event.h"
+#include "local_time.h"
 
 namespace events::parser {
+	/* time_window struct
+	 * This struct selects the events a parser returns. An event is
+	 * returned if it hasn't ended before begin and starts before end. The
+	 * default window contains every event.
+	 *
+	 * @begin: events that end before this are skipped
+	 * @end: events that start at or after this are skipped
+	 */
+	struct time_window {
+		util::time_point begin = util::time_point::min();
+		util::time_point end = util::time_point::max();
+
+		/* contains - check if an event is in the window
+		 * @start: start time of the event
+		 * @stop: end time of the event
+		 */
+		bool contains(util::time_point start, util::time_point stop) const
+		{
+			return stop >= begin and start < end;
+		}
+	};
+
 	/* events_from_ics - parse events from ics data
 	 * @ics_str: a string containing the icalendar data
+	 * @window: the events to return
+	 * @threads: maximum number of threads used for parsing
+	 * @skipped: if not null, set to the number of malformed events and
+	 *           lines that were skipped
 	 *
 	 * Returns a list containing the events parsed from the icalendar data.
-	 * Throws std::runtime_error or std::out_of_range if the parsing fails in
-	 * any way.
+	 * Events outside the window are skipped as soon as their times have
+	 * been read, without decoding the rest of their properties. Malformed
+	 * events are skipped and the rest are returned. Throws
+	 * std::runtime_error if the calendar itself is malformed.
+	 *
+	 * Large data is split at the VEVENT boundaries and the parts are parsed
+	 * in parallel. The result is the same as with a single thread.
+	 */
+	std::list<event> events_from_ics(const std::string& ics_str,
+					 const time_window& window = {},
+					 unsigned threads = 1,
+					 std::size_t* skipped = nullptr);
+
+	/* events_from_feed - parse events from ics or json data
+	 * @data: a string containing either icalendar data or Google json
+	 * @window: the events to return
+	 * @threads: maximum number of threads used for parsing icalendar data
+	 * @skipped: if not null, set to the number of malformed items skipped
+	 *
+	 * Returns a list containing the events parsed from the data. The format
+	 * is detected from the first character that is not whitespace. Throws
+	 * the same exceptions as the parser for the format.
 	 */
-	std::list<event> events_from_ics(const std::string& ics_str);
+	std::list<event> events_from_feed(const std::string& data,
+					  const time_window& window = {},
+					  unsigned threads = 1,
+					  std::size_t* skipped = nullptr);
 
 	/* events_from_json - parse events from json data
 	 * @json_str: a string containing the json data
+	 * @window: the events to return
+	 * @skipped: if not null, set to the number of malformed events that
+	 *           were skipped
 	 *
-	 * Returns a list containing the events parsed from the json. Throws
-	 * std::runtime_error if the parsing fails in any way.
+	 * Returns a list containing the events parsed from the json. The
+	 * strings of events outside the window are not decoded. Malformed
+	 * events are skipped and the rest are returned. Throws
+	 * std::runtime_error if the json or its header is malformed.
 	 */
-	std::list<event> events_from_json(const std::string& json_str);
+	std::list<event> events_from_json(const std::string& json_str,
+					  const time_window& window = {},
+					  std::size_t* skipped = nullptr);
 }
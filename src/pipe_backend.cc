@@ -0,0 +1,90 @@
+#include "pipe_backend.h"
+
+#include <stdexcept>
+#include <thread>
+#include <utility>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "parser.h"
+
+events::pipe_backend::pipe_backend(const std::string& path) :
+	complete_{false},
+	fd_{STDIN_FILENO},
+	path_{path}
+{
+	// A named pipe is opened without blocking so that the program doesn't
+	// wait for a writer
+	if (path_ != "-") {
+		fd_ = open(path_.c_str(), O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+
+		if (fd_ < 0)
+			throw std::runtime_error{"failed to open " + path_};
+	}
+}
+
+events::pipe_backend::~pipe_backend()
+{
+	if (fd_ != STDIN_FILENO)
+		close(fd_);
+}
+
+void
+events::pipe_backend::lower_cooldown()
+{
+	// Nothing to do, update() has already dropped the data
+}
+
+std::optional<std::list<events::event>>
+events::pipe_backend::update()
+{
+	const std::string data = std::move(buffer_);
+
+	buffer_.clear();
+	complete_ = false;
+
+	try {
+		return parser::events_from_feed(data, {util::now()},
+						std::thread::hardware_concurrency());
+	} catch (...) {
+		return std::nullopt;
+	}
+}
+
+const std::string&
+events::pipe_backend::path() const
+{
+	return path_;
+}
+
+bool
+events::pipe_backend::ready() const
+{
+	// Data written after the end of a document belongs to the next one
+	if (complete_)
+		return true;
+
+	pollfd pfd{fd_, POLLIN, 0};
+	char chunk[4096];
+
+	// Only read while poll() guarantees that read() doesn't block
+	while (poll(&pfd, 1, 0) > 0 and (pfd.revents & (POLLIN | POLLHUP))) {
+		const ssize_t length = read(fd_, chunk, sizeof(chunk));
+
+		if (length > 0) {
+			buffer_.append(chunk, length);
+			continue;
+		}
+
+		// The writer has closed its end. Without data this is just a
+		// pipe that has no writer
+		if (length == 0 and not buffer_.empty())
+			complete_ = true;
+
+		break;
+	}
+
+	return complete_;
+}
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <list>
+#include <optional>
+#include <string>
+
+#include "event.h"
+#include "event_backend_interface.h"
+
+namespace events {
+/* pipe_backend class
+ * This class provides events from ics or Google json data written to a
+ * named pipe or the standard input. The data is collected without blocking
+ * and parsed once the writing end has been closed. A named pipe can be
+ * written again afterwards, e.g. to replay a feed with cat.
+ */
+class pipe_backend : public event_backend_interface {
+public:
+	/* ctor
+	 * @path: path to the named pipe or "-" for the standard input
+	 *
+	 * Throws std::runtime_error if the pipe can't be opened
+	 */
+	pipe_backend(const std::string& path);
+	/* explicitly deleted copy ctor */
+	pipe_backend(const pipe_backend& rhs) = delete;
+
+	/* dtor
+	 *
+	 * This function closes the named pipe
+	 */
+	~pipe_backend();
+
+	/* lower_cooldown - implemented from the event_backend_interface
+	 *
+	 * Data that couldn't be parsed is dropped and the next data is waited
+	 * for
+	 */
+	void lower_cooldown() override;
+	/* update - implemented from the event_backend_interface */
+	std::optional<std::list<event>> update() override;
+
+	/* path - get the path
+	 *
+	 * Returns the path of the pipe
+	 */
+	const std::string& path() const;
+	/* ready - implemented from the event_backend_interface
+	 *
+	 * Reads the available data and returns true once the writing end has
+	 * been closed
+	 */
+	bool ready() const override;
+
+protected:
+	mutable std::string buffer_;
+	mutable bool complete_;
+	int fd_;
+	std::string path_;
+};
+}
@@ -1,34 +1,51 @@
 #include "pop_calendar_backend.h"
 
+#include <thread>
+
 #include "parser.h"
 
-using boost::posix_time::seconds;
-using boost::posix_time::min_date_time;
-using boost::posix_time::second_clock;
+using std::chrono::hours;
+using std::chrono::minutes;
+using std::chrono::seconds;
 
 events::pop_calendar_backend::pop_calendar_backend() :
-	cooldown_{1, 0, 0, 0},
-	error_cooldown_{0, 10, 0, 0},
-	last_update_{min_date_time},
-	was_error_{false}
+	schedule_{hours(1), minutes(10)}
 {}
 
 void
 events::pop_calendar_backend::lower_cooldown()
 {
-	was_error_ = true;
+	schedule_.fail();
+}
+
+void
+events::pop_calendar_backend::restore(const std::list<event>& events,
+				      std::uint64_t hash)
+{
+	// Events parsed in this run are never older than the restored ones
+	if (parsed_hash_)
+		return;
+
+	parsed_events_ = events;
+	parsed_hash_ = hash;
+}
+
+void
+events::pop_calendar_backend::set_cache_dir(const std::string& dir)
+{
+	db_.set_cache_dir(dir);
 }
 
 void
 events::pop_calendar_backend::set_cooldown(unsigned long secs)
 {
-	cooldown_ = seconds(secs);
+	schedule_.set_cooldown(seconds(secs));
 }
 
 void
 events::pop_calendar_backend::set_error_cooldown(unsigned long secs)
 {
-	error_cooldown_ = seconds(secs);
+	schedule_.set_error_cooldown(seconds(secs));
 }
 
 void
@@ -45,54 +62,64 @@ events::pop_calendar_backend::update()
 	std::string response;
 	bool updated;
 
+	schedule_.start();
+
 	try {
 		response = db_.get_response();
 		updated = true;
+	} catch (const http_error& e) {
+		if (e.retry_after() > 0)
+			schedule_.retry_after(seconds(e.retry_after()));
+
+		updated = false;
 	} catch (...) {
 		updated = false;
 	}
 
-	last_update_ = second_clock::universal_time();
-
 	if (updated) {
-		std::list<event> events;
-
-		try {
-			events = parser::events_from_ics(response);
-		} catch (...) {
-			return std::nullopt;
+		// The parser is skipped if the body is the same that was
+		// parsed the last time, possibly before a restart
+		if (parsed_hash_ != db_.content_hash()) {
+			try {
+				parsed_events_ = parser::events_from_ics(response, {util::now()},
+									 std::thread::hardware_concurrency());
+			} catch (...) {
+				return std::nullopt;
+			}
+
+			parsed_hash_ = db_.content_hash();
 		}
 
-		if (was_error_)
-			was_error_ = false;
+		schedule_.succeed();
 
-		return events;
+		return parsed_events_;
 	}
 
 	return std::nullopt;
 }
 
-time_duration
+std::uint64_t
+events::pop_calendar_backend::content_hash() const
+{
+	return parsed_hash_.value_or(0);
+}
+
+std::chrono::seconds
 events::pop_calendar_backend::cooldown() const
 {
-	return cooldown_;
+	return schedule_.cooldown();
 }
 
-time_duration
+std::chrono::seconds
 events::pop_calendar_backend::error_cooldown() const
 {
-	return error_cooldown_;
+	return schedule_.error_cooldown();
 }
 
 bool
 events::pop_calendar_backend::ready() const
 {
-	auto diff = second_clock::universal_time() - last_update_;
-	
-	if (was_error_)
-		return diff >= error_cooldown_;
-	else
-		return diff >= cooldown_;
+	return schedule_.ready();
 }
 
 std::string_view
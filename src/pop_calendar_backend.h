@@ -1,18 +1,16 @@
 #pragma once
 
+#include <chrono>
+#include <cstdint>
 #include <list>
 #include <optional>
 #include <string>
 #include <string_view>
 
-#include <boost/date_time.hpp>
-
 #include "db_connection.h"
 #include "event.h"
 #include "event_backend_interface.h"
-
-using boost::posix_time::ptime;
-using boost::posix_time::time_duration;
+#include "refresh_schedule.h"
 
 namespace events {
 /* pop_calendar_backend class
@@ -35,6 +33,19 @@ public:
 
 	/* lower_cooldown - implemented from the event_backend_interface */
 	void lower_cooldown() override;
+	/* restore - implemented from the event_backend_interface
+	 *
+	 * The events are returned instead of parsing the calendar if it
+	 * hasn't changed since they were parsed
+	 */
+	void restore(const std::list<event>& events, std::uint64_t hash) override;
+	/* set_cache_dir - keep the responses on disk
+	 * @dir: directory for the response cache
+	 *
+	 * Stores the fetched calendar in dir so that unchanged calendars are
+	 * not downloaded again, even after a restart
+	 */
+	void set_cache_dir(const std::string& dir);
 	/* set_cooldown - sets the normal cooldown value
 	 * @seconds: cooldown in seconds
 	 */
@@ -52,18 +63,18 @@ public:
 	/* update - implemented from the event_backend_interface */
 	std::optional<std::list<event>> update() override;
 
+	/* content_hash - implemented from the event_backend_interface */
+	std::uint64_t content_hash() const override;
 	/* cooldown - get the cooldown value
 	 *
-	 * Returns boost::posix_time::time_duration representation of the
-	 * cooldown.
+	 * Returns the cooldown
 	 */
-	time_duration cooldown() const;
+	std::chrono::seconds cooldown() const;
 	/* error_cooldown - ge the error cooldown value
 	 *
-	 * Returns boost::posix_time::time_duration representation of the 
-	 * error cooldown value.
+	 * Returns the error cooldown
 	 */
-	time_duration error_cooldown() const;
+	std::chrono::seconds error_cooldown() const;
 	/* ready - implemented from the event_backend_interface */
 	bool ready() const override;
 	/* url - get the url
@@ -73,11 +84,10 @@ public:
 	std::string_view url() const;
 
 protected:
-	time_duration cooldown_;
 	db_connection db_;
-	time_duration error_cooldown_;
-	ptime last_update_;
+	std::list<event> parsed_events_;
+	std::optional<std::uint64_t> parsed_hash_;
 	std::string url_;
-	bool was_error_;
+	refresh_schedule schedule_;
 };
 }
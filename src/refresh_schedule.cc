@@ -0,0 +1,131 @@
+#include "refresh_schedule.h"
+
+#include <algorithm>
+#include <random>
+
+/* jitter - spread of the normal cooldown in both directions */
+constexpr double jitter = 0.1;
+/* max_doublings - limit for the backoff exponent */
+constexpr unsigned max_doublings = 16;
+
+/* random_factor - get a random number
+ * @low: lower bound
+ * @high: upper bound
+ *
+ * Returns a uniformly distributed number in [low, high]
+ */
+static double random_factor(double low, double high);
+/* scale - multiply a duration
+ * @duration: the duration
+ * @factor: the multiplier
+ *
+ * Returns the scaled duration as a steady clock duration
+ */
+static std::chrono::milliseconds scale(std::chrono::seconds duration, double factor);
+
+events::refresh_schedule::refresh_schedule(std::chrono::seconds cooldown,
+					   std::chrono::seconds error_cooldown) :
+	cooldown_{cooldown},
+	error_cooldown_{error_cooldown},
+	failures_{0},
+	hold_until_{clock::time_point::min()},
+	last_start_{clock::time_point::min()},
+	next_{clock::time_point::min()}
+{}
+
+void
+events::refresh_schedule::fail()
+{
+	if (failures_ < max_doublings)
+		failures_++;
+
+	// Double the error cooldown for every failure in a row but never wait
+	// longer than a normal update would
+	const auto limit = std::max(cooldown_, error_cooldown_);
+	auto delay = error_cooldown_;
+
+	for (unsigned i = 1; i < failures_ and delay < limit; i++)
+		delay = delay*2;
+
+	delay = std::min(delay, limit);
+
+	next_ = std::max(last_start_ + scale(delay, random_factor(0.5, 1.0)),
+			 hold_until_);
+}
+
+void
+events::refresh_schedule::retry_after(std::chrono::seconds delay)
+{
+	hold_until_ = last_start_ + scale(delay, 1.0);
+	next_ = std::max(next_, hold_until_);
+}
+
+void
+events::refresh_schedule::set_cooldown(std::chrono::seconds cooldown)
+{
+	cooldown_ = cooldown;
+}
+
+void
+events::refresh_schedule::set_error_cooldown(std::chrono::seconds error_cooldown)
+{
+	error_cooldown_ = error_cooldown;
+}
+
+void
+events::refresh_schedule::start()
+{
+	hold_until_ = clock::time_point::min();
+	last_start_ = clock::now();
+	next_ = last_start_ + scale(cooldown_, random_factor(1.0 - jitter, 1.0 + jitter));
+}
+
+void
+events::refresh_schedule::succeed()
+{
+	failures_ = 0;
+}
+
+std::chrono::seconds
+events::refresh_schedule::cooldown() const
+{
+	return cooldown_;
+}
+
+std::chrono::seconds
+events::refresh_schedule::error_cooldown() const
+{
+	return error_cooldown_;
+}
+
+bool
+events::refresh_schedule::ready() const
+{
+	return clock::now() >= next_;
+}
+
+std::chrono::milliseconds
+events::refresh_schedule::wait() const
+{
+	const auto now = clock::now();
+
+	if (now >= next_)
+		return std::chrono::milliseconds{0};
+
+	return std::chrono::duration_cast<std::chrono::milliseconds>(next_ - now);
+}
+
+static double
+random_factor(double low, double high)
+{
+	// Seeded per process so that the displays pick different times
+	static std::mt19937 engine{std::random_device{}()};
+
+	return std::uniform_real_distribution<double>{low, high}(engine);
+}
+
+static std::chrono::milliseconds
+scale(std::chrono::seconds duration, double factor)
+{
+	return std::chrono::milliseconds(static_cast<long long>(duration.count()*1000*factor));
+}
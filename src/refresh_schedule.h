@@ -0,0 +1,91 @@
+#pragma once
+
+#include <chrono>
+
+namespace events {
+/* refresh_schedule class
+ * This class decides when an event backend may contact its server again.
+ *
+ * After every update the next one is scheduled one cooldown later. The
+ * cooldown is stretched or shrunk by up to 10% at random so that displays
+ * started at the same time drift apart instead of hitting the server at the
+ * same second. After a failure the error cooldown is used instead and it is
+ * doubled for every further failure in a row, up to the normal cooldown.
+ * The failure delays are randomized between half and all of their value.
+ * A delay requested by the server always takes precedence.
+ */
+class refresh_schedule {
+public:
+	/* refresh_schedule - ctor
+	 * @cooldown: time between updates
+	 * @error_cooldown: time before the first retry after a failure
+	 *
+	 * The schedule is ready right away, so that a display starting without
+	 * cached events fetches them at once. Only the later updates are
+	 * spread out.
+	 */
+	refresh_schedule(std::chrono::seconds cooldown, std::chrono::seconds error_cooldown);
+	/* refresh_schedule - explicitly deleted copy ctor */
+	refresh_schedule(const refresh_schedule& rhs) = delete;
+
+	/* ~refresh_schedule - explicitly defaulted dtor */
+	~refresh_schedule() = default;
+
+	/* fail - record that the last update failed
+	 *
+	 * Reschedules the next update using the error cooldown with backoff
+	 */
+	void fail();
+	/* retry_after - record a delay requested by the server
+	 * @delay: time to wait counted from the last update
+	 *
+	 * The next update is not scheduled before the delay has passed even if
+	 * fail() is called afterwards
+	 */
+	void retry_after(std::chrono::seconds delay);
+	/* set_cooldown - set the time between updates
+	 * @cooldown: the new cooldown
+	 */
+	void set_cooldown(std::chrono::seconds cooldown);
+	/* set_error_cooldown - set the time before the first retry
+	 * @error_cooldown: the new error cooldown
+	 */
+	void set_error_cooldown(std::chrono::seconds error_cooldown);
+	/* start - record that an update is started
+	 *
+	 * Schedules the next update one randomized cooldown from now
+	 */
+	void start();
+	/* succeed - record that the last update succeeded
+	 *
+	 * Resets the backoff so that the next failure uses the error cooldown
+	 */
+	void succeed();
+
+	/* cooldown - get the time between updates */
+	std::chrono::seconds cooldown() const;
+	/* error_cooldown - get the time before the first retry */
+	std::chrono::seconds error_cooldown() const;
+	/* ready - check if the next update is due
+	 *
+	 * Returns true if the scheduled time has been reached
+	 */
+	bool ready() const;
+	/* wait - get the time until the next update
+	 *
+	 * Returns the time left until ready() returns true, zero if it
+	 * already does
+	 */
+	std::chrono::milliseconds wait() const;
+
+protected:
+	using clock = std::chrono::steady_clock;
+
+	std::chrono::seconds cooldown_;
+	std::chrono::seconds error_cooldown_;
+	unsigned failures_;
+	clock::time_point hold_until_;
+	clock::time_point last_start_;
+	clock::time_point next_;
+};
+}
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <memory>
+#include <string_view>
+#include <utility>
+
+namespace ui {
+/* surface class
+ * This abstract class represents a rectangular area of a render target that
+ * can be drawn on. Coordinates are relative to the top left corner of the
+ * surface and drawing outside of the surface is clipped.
+ */
+class surface {
+public:
+	virtual ~surface() = default;
+
+	/* clear_area - erase the contents of the surface */
+	virtual void clear_area() = 0;
+	/* draw_border - draw a border around the edges of the surface */
+	virtual void draw_border() = 0;
+	/* effect_off - stop using effects
+	 * @attrs: the effects to stop using
+	 */
+	virtual void effect_off(unsigned attrs) = 0;
+	/* effect_on - start using effects
+	 * @attrs: the effects to use for the following prints
+	 */
+	virtual void effect_on(unsigned attrs) = 0;
+	/* print - print wide text
+	 * @x: x position
+	 * @y: y position
+	 * @text: text to print
+	 */
+	virtual void print(unsigned x, unsigned y, std::wstring_view text) = 0;
+	/* print - print narrow text
+	 * @x: x position
+	 * @y: y position
+	 * @text: text to print
+	 */
+	virtual void print(unsigned x, unsigned y, std::string_view text) = 0;
+	/* subsurface - create a surface inside this one
+	 * @from: top left corner relative to this surface
+	 * @to: bottom right corner relative to this surface
+	 *
+	 * Returns a pointer to the new surface. The new surface shares its
+	 * contents with this one and has to be destroyed before it.
+	 */
+	virtual std::unique_ptr<surface>
+	subsurface(std::pair<unsigned, unsigned> from,
+		   std::pair<unsigned, unsigned> to) = 0;
+	/* touch - mark the whole surface as changed */
+	virtual void touch() = 0;
+	/* update - show the changes made to the surface */
+	virtual void update() = 0;
+};
+
+/* render_target class
+ * This abstract class represents the screen, or something acting as one, that
+ * the windows are drawn on
+ */
+class render_target {
+public:
+	virtual ~render_target() = default;
+
+	/* clear_screen - clear the whole target */
+	virtual void clear_screen() = 0;
+	/* create_surface - create a top level surface
+	 * @from: top left corner of the surface
+	 * @to: bottom right corner of the surface
+	 *
+	 * Returns a pointer to the new surface
+	 */
+	virtual std::unique_ptr<surface>
+	create_surface(std::pair<unsigned, unsigned> from,
+		       std::pair<unsigned, unsigned> to) = 0;
+	/* resize - update the target after the screen has been resized
+	 *
+	 * Returns a pair containing the new width and height of the target
+	 */
+	virtual std::pair<unsigned, unsigned> resize() = 0;
+	/* size - get the size of the target
+	 *
+	 * Returns a pair containing the width and height of the target
+	 */
+	virtual std::pair<unsigned, unsigned> size() const = 0;
+};
+}
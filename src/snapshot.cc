@@ -0,0 +1,385 @@
+#include "snapshot.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <stdexcept>
+#include <string_view>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/* magic - identifies a snapshot file */
+constexpr char magic[8] = {'I', 'T', 'V', 'S', 'N', 'A', 'P', '\0'};
+/* format_version - version of the snapshot format */
+constexpr std::uint32_t format_version = 6;
+/* hilight_flag - record flag set for highlighted events */
+constexpr std::uint32_t hilight_flag = 1;
+
+/* header struct
+ * This struct is stored at the beginning of a snapshot file. The records
+ * start at records_offset, which is aligned for them, and are followed by
+ * event_count records, a string table of string_count wide characters and a
+ * byte table of byte_count bytes.
+ *
+ * The names and locations are stored in the string table. The key, the ids
+ * and the descriptions are byte strings, the descriptions encoded as utf-8,
+ * and they are stored in the byte table as they are.
+ *
+ * @magic: identifies the file as a snapshot
+ * @version: version of the format
+ * @wchar_size: size of the characters in the string table
+ * @records_offset: offset of the first record from the start of the file
+ * @event_count: number of records
+ * @string_count: number of characters in the string table
+ * @byte_count: number of bytes in the byte table
+ * @key_offset: offset of the key in the byte table
+ * @key_length: length of the key
+ * @content_hash: hash of the data the events were parsed from, e.g. the
+ *                response of a server, or 0 if it isn't known
+ */
+struct header {
+	char magic[8];
+	std::uint32_t version;
+	std::uint32_t wchar_size;
+	std::uint32_t records_offset;
+	std::uint32_t event_count;
+	std::uint32_t string_count;
+	std::uint32_t byte_count;
+	std::uint32_t key_offset;
+	std::uint32_t key_length;
+	std::uint64_t content_hash;
+};
+
+/* string_ref struct
+ * This struct refers to a string in the string or the byte table
+ *
+ * @offset: offset of the first character
+ * @length: number of characters
+ */
+struct string_ref {
+	std::uint32_t offset;
+	std::uint32_t length;
+};
+
+/* record struct
+ * This struct stores a single event. The times are seconds since the epoch.
+ */
+struct record {
+	std::int64_t start;
+	std::int64_t end;
+	string_ref name;
+	string_ref location;
+	string_ref description;
+	string_ref id;
+	std::uint32_t source;
+	std::uint32_t flags;
+};
+
+// The records are read in place from the mapped file, which is page aligned
+static_assert(sizeof(header) % alignof(record) == 0,
+	      "records following the header are misaligned");
+static_assert(sizeof(record) % alignof(wchar_t) == 0,
+	      "string table following the records is misaligned");
+
+/* add_string - add a string to a string table
+ * @table: the string or the byte table
+ * @str: the string to add
+ *
+ * Returns a reference to the string in the table
+ */
+template<typename Char>
+static string_ref add_string(std::basic_string<Char>& table,
+			     std::basic_string_view<Char> str);
+/* from_epoch - convert seconds since the epoch to a time point */
+static util::time_point from_epoch(std::int64_t secs);
+/* get_string - get a string from a string table
+ * @table: pointer to the string or the byte table
+ * @size: number of characters in the table
+ * @ref: reference to the string
+ *
+ * Returns a view to the string. Throws std::runtime_error if the reference
+ * points outside of the table.
+ */
+template<typename Char>
+static std::basic_string_view<Char> get_string(const Char* table,
+						std::size_t size,
+						const string_ref& ref);
+/* to_epoch - convert a time point to seconds since the epoch */
+static std::int64_t to_epoch(util::time_point time);
+
+events::snapshot::snapshot(const std::string& path) :
+	bytes_{nullptr},
+	content_hash_{0},
+	data_{nullptr},
+	event_count_{0},
+	records_{nullptr},
+	size_{0},
+	strings_{nullptr}
+{
+	const int fd = open(path.c_str(), O_RDONLY);
+	if (fd < 0)
+		throw std::runtime_error{"failed to open the snapshot"};
+
+	struct stat st;
+	if (fstat(fd, &st) != 0 or st.st_size == 0) {
+		close(fd);
+		throw std::runtime_error{"failed to read the snapshot"};
+	}
+
+	size_ = st.st_size;
+	void* data = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	close(fd);
+
+	if (data == MAP_FAILED)
+		throw std::runtime_error{"failed to map the snapshot"};
+
+	data_ = static_cast<const char*>(data);
+
+	try {
+		if (size_ < sizeof(header))
+			throw std::runtime_error{"snapshot is too small"};
+
+		header h;
+		std::memcpy(&h, data_, sizeof(h));
+
+		if (std::memcmp(h.magic, magic, sizeof(magic)) != 0)
+			throw std::runtime_error{"file is not a snapshot"};
+		if (h.version != format_version)
+			throw std::runtime_error{"snapshot has an unsupported version"};
+		if (h.wchar_size != sizeof(wchar_t))
+			throw std::runtime_error{"snapshot has an unsupported character size"};
+
+		const std::size_t records_size = std::size_t(h.event_count)*sizeof(record);
+		const std::size_t strings_size = std::size_t(h.string_count)*sizeof(wchar_t);
+
+		if (h.records_offset < sizeof(header) or
+		    h.records_offset % alignof(record) != 0)
+			throw std::runtime_error{"snapshot has misaligned records"};
+		if (size_ != h.records_offset + records_size + strings_size + h.byte_count)
+			throw std::runtime_error{"snapshot has a wrong size"};
+
+		content_hash_ = h.content_hash;
+		event_count_ = h.event_count;
+		records_ = data_ + h.records_offset;
+		strings_ = reinterpret_cast<const wchar_t*>(records_ + records_size);
+		bytes_ = records_ + records_size + strings_size;
+		key_ = get_string(bytes_, h.byte_count, {h.key_offset, h.key_length});
+
+		// Checking every reference once lets at() hand out views without
+		// looking at the table size again
+		const auto records = reinterpret_cast<const record*>(records_);
+
+		for (std::size_t i = 0; i < event_count_; i++) {
+			get_string(strings_, h.string_count, records[i].name);
+			get_string(strings_, h.string_count, records[i].location);
+			get_string(bytes_, h.byte_count, records[i].description);
+			get_string(bytes_, h.byte_count, records[i].id);
+
+			if (records[i].start > records[i].end)
+				throw std::runtime_error{"snapshot has an invalid event"};
+		}
+	} catch (...) {
+		munmap(const_cast<char*>(data_), size_);
+		throw;
+	}
+}
+
+events::snapshot::~snapshot()
+{
+	munmap(const_cast<char*>(data_), size_);
+}
+
+events::snapshot::entry
+events::snapshot::at(std::size_t index) const
+{
+	if (index >= event_count_)
+		throw std::out_of_range{"snapshot entry is out of range"};
+
+	const record& r = reinterpret_cast<const record*>(records_)[index];
+
+	return entry{from_epoch(r.start),
+		     from_epoch(r.end),
+		     std::wstring_view{strings_ + r.name.offset, r.name.length},
+		     std::wstring_view{strings_ + r.location.offset, r.location.length},
+		     std::string_view{bytes_ + r.description.offset, r.description.length},
+		     std::string_view{bytes_ + r.id.offset, r.id.length},
+		     r.source,
+		     (r.flags & hilight_flag) != 0};
+}
+
+std::list<events::event>
+events::snapshot::events() const
+{
+	std::list<event> events;
+
+	for (std::size_t i = 0; i < event_count_; i++) {
+		const auto e = at(i);
+
+		events.emplace_back(std::wstring{e.name},
+				    e.start,
+				    e.end);
+
+		if (not e.location.empty())
+			events.back().set_location(std::wstring{e.location});
+		if (not e.description.empty())
+			events.back().set_description(std::string{e.description});
+		if (not e.id.empty())
+			events.back().set_id(std::string{e.id});
+
+		events.back().set_source(e.source);
+		events.back().set_hilight(e.hilight);
+	}
+
+	return events;
+}
+
+std::uint64_t
+events::snapshot::content_hash() const
+{
+	return content_hash_;
+}
+
+std::string_view
+events::snapshot::key() const
+{
+	return key_;
+}
+
+std::size_t
+events::snapshot::size() const
+{
+	return event_count_;
+}
+
+std::list<events::event>
+events::load_snapshot(const std::string& path,
+		      const std::string& key,
+		      std::uint64_t* content_hash)
+{
+	const snapshot file{path};
+
+	if (file.key() != key)
+		throw std::runtime_error{"snapshot has a different key"};
+
+	if (content_hash)
+		*content_hash = file.content_hash();
+
+	return file.events();
+}
+
+void
+events::save_snapshot(const std::string& path,
+		      const std::string& key,
+		      const std::list<event>& events,
+		      std::uint64_t content_hash)
+{
+	std::vector<record> records;
+	std::wstring strings;
+	std::string bytes;
+
+	records.reserve(events.size());
+
+	const auto key_ref = add_string(bytes, std::string_view{key});
+
+	for (const auto& e : events)
+		records.push_back(record{to_epoch(e.start()),
+					 to_epoch(e.end()),
+					 add_string(strings, e.name()),
+					 add_string(strings, e.location()),
+					 add_string(bytes, e.description()),
+					 add_string(bytes, e.id()),
+					 e.source(),
+					 e.hilight() ? hilight_flag : 0});
+
+	header h;
+	std::memcpy(h.magic, magic, sizeof(magic));
+	h.version = format_version;
+	h.wchar_size = sizeof(wchar_t);
+	h.records_offset = sizeof(header);
+	h.event_count = records.size();
+	h.string_count = strings.size();
+	h.byte_count = bytes.size();
+	h.key_offset = key_ref.offset;
+	h.key_length = key_ref.length;
+	h.content_hash = content_hash;
+
+	const std::string temp_path = path + ".tmp." + std::to_string(getpid());
+
+	{
+		std::ofstream out{temp_path, std::ios::out | std::ios::binary | std::ios::trunc};
+
+		out.write(reinterpret_cast<const char*>(&h), sizeof(h));
+		out.write(reinterpret_cast<const char*>(records.data()),
+			  records.size()*sizeof(record));
+		out.write(reinterpret_cast<const char*>(strings.data()),
+			  strings.size()*sizeof(wchar_t));
+		out.write(bytes.data(), bytes.size());
+
+		if (not out) {
+			std::remove(temp_path.c_str());
+			throw std::runtime_error{"failed to write the snapshot"};
+		}
+	}
+
+	if (std::rename(temp_path.c_str(), path.c_str()) != 0) {
+		std::remove(temp_path.c_str());
+		throw std::runtime_error{"failed to replace the snapshot"};
+	}
+}
+
+std::string
+events::snapshot_path(const std::string& dir, const std::string& key)
+{
+	// 64-bit FNV-1a keeps the file names the same between builds
+	std::uint64_t hash = 0xcbf29ce484222325;
+
+	for (const unsigned char c : key) {
+		hash ^= c;
+		hash *= 0x100000001b3;
+	}
+
+	char name[32];
+	std::snprintf(name, sizeof(name), "%016llx.snap",
+		      static_cast<unsigned long long>(hash));
+
+	return dir + '/' + name;
+}
+
+template<typename Char>
+static string_ref
+add_string(std::basic_string<Char>& table, std::basic_string_view<Char> str)
+{
+	const string_ref ref{static_cast<std::uint32_t>(table.size()),
+			     static_cast<std::uint32_t>(str.size())};
+
+	table.append(str);
+
+	return ref;
+}
+
+static util::time_point
+from_epoch(std::int64_t secs)
+{
+	return util::time_point{std::chrono::seconds{secs}};
+}
+
+template<typename Char>
+static std::basic_string_view<Char>
+get_string(const Char* table, std::size_t size, const string_ref& ref)
+{
+	if (std::size_t(ref.offset) + ref.length > size)
+		throw std::runtime_error{"snapshot string is out of bounds"};
+
+	return std::basic_string_view<Char>{table + ref.offset, ref.length};
+}
+
+static std::int64_t
+to_epoch(util::time_point time)
+{
+	return time.time_since_epoch().count();
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <string>
+#include <string_view>
+
+#include "event.h"
+
+namespace events {
+/* snapshot class
+ * This class gives read access to a snapshot file without decoding it. The
+ * file is memory-mapped and every entry refers directly into the mapping, so
+ * other processes can read the events of a running instance cheaply.
+ */
+class snapshot {
+public:
+	/* entry struct
+	 * This struct represents a single event of the snapshot. The strings
+	 * point into the mapped file and stay valid as long as the snapshot.
+	 *
+	 * @start: start time of the event
+	 * @end: end time of the event
+	 * @name: name of the event
+	 * @location: location of the event
+	 * @description: description of the event encoded as utf-8
+	 * @id: id of the event
+	 * @source: index of the event source
+	 * @hilight: whether the event is highlighted
+	 */
+	struct entry {
+		util::time_point start;
+		util::time_point end;
+		std::wstring_view name;
+		std::wstring_view location;
+		std::string_view description;
+		std::string_view id;
+		unsigned source;
+		bool hilight;
+	};
+
+	/* snapshot - ctor
+	 * @path: path to the snapshot file
+	 *
+	 * Maps the file and validates the header and all string references so
+	 * that the entries can be accessed without further checks. Throws
+	 * std::runtime_error if the file can't be read or is malformed.
+	 */
+	snapshot(const std::string& path);
+	/* snapshot - explicitly deleted copy ctor */
+	snapshot(const snapshot& rhs) = delete;
+
+	/* ~snapshot - dtor
+	 *
+	 * This function unmaps the file
+	 */
+	~snapshot();
+
+	/* at - get an entry
+	 * @index: index of the entry
+	 *
+	 * Returns the entry. Throws std::out_of_range if index is not smaller
+	 * than size().
+	 */
+	entry at(std::size_t index) const;
+	/* events - decode the events
+	 *
+	 * Returns a list containing a copy of every entry as an event
+	 */
+	std::list<event> events() const;
+	/* content_hash - get the hash of the source data
+	 *
+	 * Returns the hash of the data the events were parsed from, 0 if it
+	 * wasn't saved
+	 */
+	std::uint64_t content_hash() const;
+	/* key - get the key
+	 *
+	 * Returns the key the snapshot was saved with
+	 */
+	std::string_view key() const;
+	/* size - get the number of entries
+	 *
+	 * Returns the number of events stored in the snapshot
+	 */
+	std::size_t size() const;
+
+protected:
+	const char* bytes_;
+	std::uint64_t content_hash_;
+	const char* data_;
+	std::size_t event_count_;
+	std::string_view key_;
+	const char* records_;
+	std::size_t size_;
+	const wchar_t* strings_;
+};
+
+/* load_snapshot - read events from a snapshot file
+ * @path: path to the snapshot file
+ * @key: key the snapshot has to have been saved with
+ * @content_hash: if not null, set to the hash of the data the events were
+ *                parsed from
+ *
+ * Returns a list containing the events stored in the snapshot. Throws
+ * std::runtime_error if the file can't be read, is malformed or was saved
+ * with a different key.
+ */
+std::list<event> load_snapshot(const std::string& path,
+			       const std::string& key,
+			       std::uint64_t* content_hash = nullptr);
+/* save_snapshot - write events to a snapshot file
+ * @path: path to the snapshot file
+ * @key: key identifying the source of the events
+ * @events: the events to store
+ * @content_hash: hash of the data the events were parsed from, 0 if it is
+ *                not known
+ *
+ * The snapshot is written to a temporary file which then replaces the old
+ * snapshot so that a reader never sees a partially written file. Throws
+ * std::runtime_error if the file can't be written.
+ */
+void save_snapshot(const std::string& path,
+		   const std::string& key,
+		   const std::list<event>& events,
+		   std::uint64_t content_hash = 0);
+/* snapshot_path - get the path of a snapshot file
+ * @dir: directory containing the snapshots
+ * @key: key identifying the source of the events
+ *
+ * Returns a path inside dir with a file name derived from the key
+ */
+std::string snapshot_path(const std::string& dir, const std::string& key);
+}
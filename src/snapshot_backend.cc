@@ -0,0 +1,74 @@
+#include "snapshot_backend.h"
+
+#include <utility>
+
+#include "snapshot.h"
+
+events::snapshot_backend::snapshot_backend(std::shared_ptr<event_backend_interface> backend,
+					   const std::string& key,
+					   const std::string& path) :
+	backend_{std::move(backend)},
+	key_{key},
+	loaded_{false},
+	path_{path}
+{}
+
+void
+events::snapshot_backend::lower_cooldown()
+{
+	backend_->lower_cooldown();
+}
+
+void
+events::snapshot_backend::restore(const std::list<event>& events,
+				  std::uint64_t hash)
+{
+	backend_->restore(events, hash);
+}
+
+std::optional<std::list<events::event>>
+events::snapshot_backend::update()
+{
+	// Serve the snapshot first. If there is no usable snapshot the wrapped
+	// backend is asked right away
+	if (not loaded_) {
+		loaded_ = true;
+
+		try {
+			std::uint64_t hash;
+			auto events = load_snapshot(path_, key_, &hash);
+
+			if (hash != 0)
+				backend_->restore(events, hash);
+
+			if (not events.empty())
+				return events;
+		} catch (...) {
+		}
+	}
+
+	auto result = backend_->update();
+
+	if (result.has_value()) {
+		// A failure to save the snapshot only affects the next start
+		try {
+			save_snapshot(path_, key_, result.value(),
+				      backend_->content_hash());
+		} catch (...) {
+		}
+	}
+
+	return result;
+}
+
+bool
+events::snapshot_backend::ready() const
+{
+	return not loaded_ or backend_->ready();
+}
+
+std::uint64_t
+events::snapshot_backend::content_hash() const
+{
+	return backend_->content_hash();
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <optional>
+#include <string>
+
+#include "event.h"
+#include "event_backend_interface.h"
+
+namespace events {
+/* snapshot_backend class
+ * This class wraps another event backend and keeps a snapshot of the last
+ * events it successfully provided on disk. The first update returns the
+ * events from the snapshot without waiting for the wrapped backend so that
+ * events can be shown immediately after a restart. After that all calls are
+ * forwarded to the wrapped backend and the snapshot is replaced every time it
+ * provides new events.
+ *
+ * The snapshot also keeps the content hash of the wrapped backend, which is
+ * handed back to it together with the events after a restart. A backend
+ * that receives the same data again can then skip parsing it.
+ */
+class snapshot_backend : public event_backend_interface {
+public:
+	/* ctor
+	 * @backend: the backend to wrap
+	 * @key: key identifying the source of the events
+	 * @path: path to the snapshot file
+	 */
+	snapshot_backend(std::shared_ptr<event_backend_interface> backend,
+			 const std::string& key,
+			 const std::string& path);
+	/* explicitly deleted copy ctor */
+	snapshot_backend(const snapshot_backend& rhs) = delete;
+
+	/* explicitly defaulted dtor */
+	~snapshot_backend() = default;
+
+	/* lower_cooldown - implemented from the event_backend_interface */
+	void lower_cooldown() override;
+	/* restore - implemented from the event_backend_interface */
+	void restore(const std::list<event>& events, std::uint64_t hash) override;
+	/* update - implemented from the event_backend_interface */
+	std::optional<std::list<event>> update() override;
+
+	/* ready - implemented from the event_backend_interface */
+	bool ready() const override;
+	/* content_hash - implemented from the event_backend_interface */
+	std::uint64_t content_hash() const override;
+
+protected:
+	std::shared_ptr<event_backend_interface> backend_;
+	std::string key_;
+	bool loaded_;
+	std::string path_;
+};
+}
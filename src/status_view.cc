@@ -1,6 +1,7 @@
 #include "status_view.h"
 
 #include <algorithm>
+#include <fstream>
 #include <iomanip>
 #include <sstream>
 
@@ -27,7 +28,7 @@ util::status_view::set_logo(const std::string& path)
 }
 
 void
-util::status_view::set_system_time(const ptime& time)
+util::status_view::set_system_time(time_point time)
 {
 	system_time_ = time;
 }
@@ -41,13 +42,9 @@ util::status_view::set_system_message(const std::wstring& msg)
 void
 util::status_view::draw(ui::win& win) const
 {
-	const unsigned logo_height = logo_ ? logo_->height : 0;
-	const unsigned msg_height = system_msg_.empty() ? 0 : 3;
-	const unsigned height = 3 + logo_height + msg_height;
-
 	ui::win status_win{&win,
 			   {win.curx(), win.cury()},
-			   {win.curx() + win.max_width(), win.cury() + height}};
+			   {win.curx() + win.max_width(), win.cury() + height()}};
 
 	// Draw the logo
 	if (logo_)
@@ -55,22 +52,29 @@ util::status_view::draw(ui::win& win) const
 					   ui::effect::bold,
 					   ui::align::center);
 
+	static constexpr const wchar_t* months[] = {L"Jan", L"Feb", L"Mar",
+						    L"Apr", L"May", L"Jun",
+						    L"Jul", L"Aug", L"Sep",
+						    L"Oct", L"Nov", L"Dec"};
+
+	const auto local = to_local(system_time_);
+
 	// Print date and time
 	std::wstringstream time_ss;
 	time_ss << std::setw(2)
 		<< std::setfill(L'0')
-		<< system_time_.time_of_day().hours() << ":"
+		<< local.hour << ":"
 		<< std::setw(2)
 		<< std::setfill(L'0')
-		<< system_time_.time_of_day().minutes() << ":"
+		<< local.minute << ":"
 		<< std::setw(2)
 		<< std::setfill(L'0')
-		<< system_time_.time_of_day().seconds();
+		<< local.second;
 
 	std::wstringstream date_ss;
-	date_ss << system_time_.date().day() << ". "
-		<< system_time_.date().month() << " "
-		<< system_time_.date().year();
+	date_ss << local.day << ". "
+		<< months[local.month - 1] << " "
+		<< local.year;
 
 	std::wstringstream version_ss;
 	version_ss << version_w;
@@ -99,10 +103,13 @@ util::status_view::draw(ui::win& win) const
 unsigned
 util::status_view::height() const
 {
-	return 0;
+	const unsigned logo_height = logo_ ? logo_->height : 0;
+	const unsigned msg_height = system_msg_.empty() ? 0 : 3;
+
+	return 3 + logo_height + msg_height;
 }
 
-ptime
+util::time_point
 util::status_view::system_time() const
 {
 	return system_time_;
@@ -4,14 +4,10 @@
 #include <string>
 #include <string_view>
 
-#include <boost/date_time.hpp>
-
+#include "local_time.h"
 #include "ui.h"
 #include "view_interface.h"
 
-using namespace boost::posix_time;
-using namespace boost::gregorian;
-
 namespace util {
 /* status_view class
  * This class draws system info to the main window
@@ -32,11 +28,12 @@ public:
 	 */
 	void set_logo(const std::string& path);
 	/* set_system_time - set the displayed time
-	 * @time: boost::posix_time::ptime representation of time
+	 * @time: the time to display
 	 *
-	 * This function sets the time rendered by the view
+	 * This function sets the time rendered by the view. It is shown in
+	 * the local time zone.
 	 */
-	void set_system_time(const ptime& time);
+	void set_system_time(time_point time);
 	/* set_system_message - set the displayed message
 	 * @message: message displayed
 	 *
@@ -50,10 +47,9 @@ public:
 	unsigned height() const override;
 	/* system_time - return the displayed time
 	 *
-	 * Returns boost::posix_time::ptime representation of the rendered
-	 * time
+	 * Returns the rendered time
 	 */
-	ptime system_time() const;
+	time_point system_time() const;
 	/* system_message - return the system message
 	 *
 	 * Returns a string view to the system message rendered
@@ -63,6 +59,6 @@ public:
 protected:
 	ui::ascii_image* logo_;
 	std::wstring system_msg_;
-	ptime system_time_;
+	time_point system_time_;
 };
 }
@@ -0,0 +1,63 @@
+#include "subscription_backend.h"
+
+#include <sys/stat.h>
+
+#include "snapshot.h"
+
+events::subscription_backend::subscription_backend(const std::string& path) :
+	path_{path}
+{}
+
+void
+events::subscription_backend::lower_cooldown()
+{
+	// Nothing to do, ready() waits for the file to be replaced
+}
+
+std::optional<std::list<events::event>>
+events::subscription_backend::update()
+{
+	loaded_ = current_version();
+
+	try {
+		return snapshot{path_}.events();
+	} catch (...) {
+		return std::nullopt;
+	}
+}
+
+const std::string&
+events::subscription_backend::path() const
+{
+	return path_;
+}
+
+bool
+events::subscription_backend::ready() const
+{
+	const auto version = current_version();
+
+	if (not version.has_value())
+		return false;
+
+	return not loaded_.has_value() or not (loaded_.value() == version.value());
+}
+
+bool
+events::subscription_backend::file_version::operator==(const file_version& rhs) const
+{
+	return inode == rhs.inode and modified == rhs.modified and size == rhs.size;
+}
+
+std::optional<events::subscription_backend::file_version>
+events::subscription_backend::current_version() const
+{
+	struct stat st;
+
+	if (stat(path_.c_str(), &st) != 0)
+		return std::nullopt;
+
+	return file_version{st.st_ino,
+			    st.st_mtim.tv_sec*1000000000LL + st.st_mtim.tv_nsec,
+			    st.st_size};
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <list>
+#include <optional>
+#include <string>
+
+#include <sys/types.h>
+
+#include "event.h"
+#include "event_backend_interface.h"
+
+namespace events {
+/* subscription_backend class
+ * This class provides the events published by another instance. The
+ * publishing instance writes its merged events to a snapshot file, e.g. in
+ * /dev/shm, and this backend reads the file every time it is replaced. This
+ * way several displays on one host need only one instance that fetches and
+ * parses the calendars.
+ *
+ * The events keep the highlighting they had in the publishing instance.
+ */
+class subscription_backend : public event_backend_interface {
+public:
+	/* ctor
+	 * @path: path to the published snapshot file
+	 */
+	subscription_backend(const std::string& path);
+	/* explicitly deleted copy ctor */
+	subscription_backend(const subscription_backend& rhs) = delete;
+
+	/* explicitly defaulted dtor */
+	~subscription_backend() = default;
+
+	/* lower_cooldown - implemented from the event_backend_interface
+	 *
+	 * A file that couldn't be read is tried again once it is replaced
+	 */
+	void lower_cooldown() override;
+	/* update - implemented from the event_backend_interface */
+	std::optional<std::list<event>> update() override;
+
+	/* path - get the path
+	 *
+	 * Returns the path of the snapshot file
+	 */
+	const std::string& path() const;
+	/* ready - implemented from the event_backend_interface
+	 *
+	 * Returns true if the file has been replaced since the last update
+	 */
+	bool ready() const override;
+
+protected:
+	/* file_version struct
+	 * This struct identifies a version of the file. A replaced file
+	 * differs in at least one of the fields.
+	 */
+	struct file_version {
+		ino_t inode;
+		long long modified;
+		off_t size;
+
+		bool operator==(const file_version& rhs) const;
+	};
+
+	/* current_version - get the version of the file on disk
+	 *
+	 * Returns an empty optional if the file doesn't exist
+	 */
+	std::optional<file_version> current_version() const;
+
+	std::optional<file_version> loaded_;
+	std::string path_;
+};
+}
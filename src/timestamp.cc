@@ -0,0 +1,204 @@
+#include "timestamp.h"
+
+#include <stdexcept>
+
+/* cursor struct
+ * This struct walks over the timestamp one character at a time
+ */
+struct cursor {
+	const char* pos;
+	const char* end;
+
+	/* digits - read a fixed amount of decimal digits
+	 * @count: number of digits
+	 * @value: the number read
+	 *
+	 * Returns false if there are less than count digits
+	 */
+	bool digits(unsigned count, unsigned& value)
+	{
+		if (end - pos < static_cast<long>(count))
+			return false;
+
+		value = 0;
+
+		for (unsigned i = 0; i < count; i++) {
+			const unsigned digit = static_cast<unsigned char>(pos[i]) - '0';
+
+			if (digit > 9)
+				return false;
+
+			value = value*10 + digit;
+		}
+
+		pos += count;
+
+		return true;
+	}
+
+	/* skip - consume a character if it is the next one
+	 * @c: the character
+	 *
+	 * Returns true if the character was consumed
+	 */
+	bool skip(char c)
+	{
+		if (pos == end or *pos != c)
+			return false;
+
+		pos++;
+
+		return true;
+	}
+
+	/* peek - get the next character
+	 *
+	 * Returns the next character or '\0' at the end
+	 */
+	char peek() const
+	{
+		return pos == end ? '\0' : *pos;
+	}
+};
+
+/* days_in_month - get the length of a month
+ * @year: the year
+ * @month: the month, 1 to 12
+ */
+static unsigned days_in_month(unsigned year, unsigned month);
+
+bool
+events::parser::parse_timestamp(std::string_view src, timestamp& result) noexcept
+{
+	cursor c{src.data(), src.data() + src.size()};
+	unsigned year, month, day;
+
+	if (not c.digits(4, year))
+		return false;
+
+	// The basic format has no separators at all
+	const bool extended = c.skip('-');
+
+	if (not c.digits(2, month))
+		return false;
+	if (extended and not c.skip('-'))
+		return false;
+	if (not c.digits(2, day))
+		return false;
+
+	if (month < 1 or month > 12 or day < 1 or
+	    day > days_in_month(year, month))
+		return false;
+
+	unsigned hour = 0, minute = 0, second = 0, fraction = 0;
+	long offset = 0;
+	bool absolute = false;
+
+	const char separator = c.peek();
+
+	if (separator == 'T' or separator == 't' or (extended and separator == ' ')) {
+		c.pos++;
+
+		if (not c.digits(2, hour))
+			return false;
+		if (extended and not c.skip(':'))
+			return false;
+		if (not c.digits(2, minute))
+			return false;
+		if (extended and not c.skip(':'))
+			return false;
+		if (not c.digits(2, second))
+			return false;
+
+		// Keep microseconds and ignore the rest of the digits
+		if (c.skip('.') or c.skip(',')) {
+			unsigned count = 0;
+
+			for (; c.pos != c.end and *c.pos >= '0' and *c.pos <= '9'; c.pos++, count++) {
+				if (count < 6)
+					fraction = fraction*10 + (*c.pos - '0');
+			}
+
+			if (count == 0)
+				return false;
+
+			for (; count < 6; count++)
+				fraction *= 10;
+		}
+
+		// A leap second can't be represented, so it is the last second
+		// of the minute instead
+		if (hour > 23 or minute > 59 or second > 60)
+			return false;
+		if (second == 60)
+			second = 59;
+
+		const char sign = c.peek();
+
+		if (sign == 'Z' or sign == 'z') {
+			c.pos++;
+			absolute = true;
+		} else if (sign == '+' or sign == '-') {
+			unsigned offset_hours, offset_minutes = 0;
+
+			c.pos++;
+
+			if (not c.digits(2, offset_hours))
+				return false;
+
+			if (c.pos != c.end) {
+				c.skip(':');
+
+				if (not c.digits(2, offset_minutes))
+					return false;
+			}
+
+			if (offset_hours > 23 or offset_minutes > 59)
+				return false;
+
+			offset = (offset_hours*60 + offset_minutes)*60;
+
+			if (sign == '-')
+				offset = -offset;
+
+			absolute = true;
+		}
+	}
+
+	if (c.pos != c.end)
+		return false;
+
+	result.time = util::civil_time{static_cast<int>(year), month, day,
+				       hour, minute, second, 0};
+	result.fraction = fraction;
+	result.offset = offset;
+	result.absolute = absolute;
+
+	return true;
+}
+
+util::time_point
+events::parser::to_time_point(std::string_view src)
+{
+	timestamp stamp;
+
+	if (not parse_timestamp(src, stamp))
+		throw std::runtime_error{"failed to parse timestamp"};
+
+	if (not stamp.absolute)
+		return util::from_local(stamp.time);
+
+	return util::from_utc(stamp.time) - std::chrono::seconds(stamp.offset);
+}
+
+static unsigned
+days_in_month(unsigned year, unsigned month)
+{
+	static constexpr unsigned days[] = {31, 28, 31, 30, 31, 30,
+					    31, 31, 30, 31, 30, 31};
+
+	if (month == 2 and year % 4 == 0 and (year % 100 != 0 or year % 400 == 0))
+		return 29;
+
+	return days[month - 1];
+}
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <string_view>
+
+#include "local_time.h"
+
+namespace events::parser {
+	/* timestamp struct
+	 * This struct holds a timestamp as it was written
+	 *
+	 * @time: the date and time without the offset applied
+	 * @fraction: the fraction of the second in microseconds
+	 * @offset: offset from UTC in seconds, east being positive
+	 * @absolute: whether the timestamp had an offset or 'Z'. Otherwise the
+	 *            time is a local time.
+	 */
+	struct timestamp {
+		util::civil_time time;
+		unsigned fraction;
+		long offset;
+		bool absolute;
+	};
+
+	/* parse_timestamp - parse an RFC 3339 or ISO 8601 timestamp
+	 * @src: the timestamp
+	 * @result: the parsed timestamp, only written on success
+	 *
+	 * Accepts the extended format used by json (2018-01-02T04:15:20.5+03:00)
+	 * and the basic format used by icalendar (20180102T041520Z), as well as
+	 * plain dates in either format. The fraction of a second may have any
+	 * number of digits and is kept to the microsecond. The offset may be
+	 * 'Z', +hh:mm, -hh:mm, +hhmm or +hh. The whole string has to be a
+	 * timestamp.
+	 *
+	 * Returns false if src is not a valid timestamp. This function doesn't
+	 * allocate memory.
+	 */
+	bool parse_timestamp(std::string_view src, timestamp& result) noexcept;
+
+	/* to_time_point - parse a timestamp into a time point
+	 * @src: the timestamp
+	 *
+	 * Returns the time the timestamp refers to without the fraction of the
+	 * second. Timestamps without an offset are in local time. Throws
+	 * std::runtime_error if src is not a valid timestamp.
+	 */
+	util::time_point to_time_point(std::string_view src);
+}
@@ -1,115 +1,107 @@
 #include "ui.h"
 
-#include <array>
-#include <cstdlib>
-
-/* print_wchar_t - print a wide char string
- * @win: ncurses window to print on
- * @x: x position
- * @y: y position
- * @unicode_str: unicode string (wide string) to print
+#include <stdexcept>
+
+#include "curses_target.h"
+
+/* target - the render target used for drawing */
+static ui::render_target* target = nullptr;
+/* terminal - the render target for the terminal if it is used */
+static std::unique_ptr<ui::curses_target> terminal;
+
+/* current_target - get the render target in use
  *
- * This helper function prints the unicode string in the ncurses window win
- * in the coordinates provided. Should the conversion fail a std::runtime_error
- * is thrown
+ * Returns a reference to the render target. Throws std::logic_error if the
+ * screen hasn't been initialized.
  */
-static void print_wchar_t(WINDOW* win,
-			  const int x,
-			  const int y,
-			  const wchar_t* unicode_str)
-{
-	int local_x = x;
-
-	for (wchar_t* c = const_cast<wchar_t*>(unicode_str); *c != '\0'; c++) {
-		int ret;
-		std::array<char, sizeof(wchar_t) + 1> temp;
-		temp.fill('\0');
-
-		ret = std::wctomb(&temp[0], *c);
-		if (ret < 0)
-			throw std::runtime_error{"conversion from wchar_t to char failed"};
-		
-		if (ret > 0) {
-			mvwprintw(win, y, local_x, &temp[0]);
-			local_x++;
-		}
-	}
+static ui::render_target& current_target()
+{
+	if (not target)
+		throw std::logic_error{"screen has not been initialized"};
+
+	return *target;
 }
 
 void
 ui::clear()
 {
-	erase();
+	current_target().clear_screen();
 }
 
 void
 ui::screen_deinit()
 {
-	endwin();
+	target = nullptr;
+	terminal.reset();
 }
 
 void
 ui::screen_init()
 {
-	setlocale(LC_ALL, "");
-	initscr();
-	// Do not capture special key combinations
-	nocbreak();
-	// Do not echo inputs
-	noecho();
-	// Do not render cursor
-	curs_set(0);
+	terminal = std::make_unique<curses_target>();
+	target = terminal.get();
 }
 
-std::pair<unsigned, unsigned>
-ui::screen_size()
+void
+ui::screen_init(render_target* render_target)
 {
-	unsigned width, height;
+	terminal.reset();
+	target = render_target;
+}
 
-	getmaxyx(stdscr, height, width);
+std::pair<unsigned, unsigned>
+ui::screen_resize()
+{
+	return current_target().resize();
+}
 
-	return std::pair{width, height};
+std::pair<unsigned, unsigned>
+ui::screen_size()
+{
+	return current_target().size();
 }
 
 ui::win::win(std::pair<unsigned, unsigned> from,
 	     std::pair<unsigned, unsigned> to) :
+	framed_{true},
 	height_{std::get<1>(to) - std::get<1>(from)},
 	parent_{nullptr},
 	width_{std::get<0>(to) - std::get<0>(from)},
-	x_{x_padding},
-	y_{y_padding}
+	x_{x_frame_padding},
+	x_padding_{x_frame_padding},
+	y_{y_frame_padding},
+	y_padding_{y_frame_padding}
 {
-	win_ = newwin(height_, width_,
-		      std::get<1>(from), std::get<0>(from));
-	box(win_, 0, 0);
+	surface_ = current_target().create_surface(from, to);
+	surface_->draw_border();
 }
 
 ui::win::win(win* parent,
 	     std::pair<unsigned, unsigned> from,
-	     std::pair<unsigned, unsigned> to) :
+	     std::pair<unsigned, unsigned> to,
+	     const bool framed) :
+	framed_{framed},
 	height_{std::get<1>(to) - std::get<1>(from)},
 	parent_{parent},
 	width_{std::get<0>(to) - std::get<0>(from)},
-	x_{x_padding},
-	y_{y_padding}
+	x_{framed ? x_frame_padding : 0},
+	x_padding_{framed ? x_frame_padding : 0},
+	y_{framed ? y_frame_padding : 0},
+	y_padding_{framed ? y_frame_padding : 0}
 {
 	parent->newline(height_);
 
-	win_ = derwin(parent_->get_win(), height_, width_,
-		      std::get<1>(from), std::get<0>(from));
-	box(win_, 0, 0);
-}
+	surface_ = parent_->get_surface().subsurface(from, to);
 
-ui::win::~win()
-{
-	delwin(win_);
+	if (framed_)
+		surface_->draw_border();
 }
 
 ui::win&
 ui::win::newline()
 {
 	y_++;
-	x_ = x_padding;
+	x_ = x_padding_;
 
 	return *this;
 }
@@ -118,24 +110,24 @@ ui::win&
 ui::win::newline(unsigned lines)
 {
 	y_ += lines;
-	x_ = x_padding;
+	x_ = x_padding_;
 
 	return *this;
 }
 
 ui::win&
-ui::win::add_text(const std::wstring& text,
+ui::win::add_text(std::wstring_view text,
 		  const unsigned type,
 		  const unsigned pos)
 {
 	// Preload the x coordinates based on the value of pos
 	switch (pos) {
 	case left:
-		x_ = x_padding;
+		x_ = x_padding_;
 		break;
 
 	case right:
-		x_ = width_ - x_padding - text.length();
+		x_ = width_ - x_padding_ - text.length();
 		break;
 
 	case center:
@@ -147,24 +139,14 @@ ui::win::add_text(const std::wstring& text,
 		;// Nop
 	}
 
-	unsigned remaining_space = width_ - x_padding - x_;
-
-	wattron(win_, type);
+	unsigned remaining_space = width_ - x_padding_ - x_;
 
-	if (text.length() > remaining_space)
-		print_wchar_t(win_,
-			      x_, y_,
-			      text.substr(0, remaining_space).c_str());
-		//mvwprintw(win_,
-			  //y_, x_,
-			  //text.substr(0, remaining_space).c_str());
-	else
-		print_wchar_t(win_, x_, y_, text.c_str());
-		//mvwprintw(win_, y_, x_, text.c_str());
+	surface_->effect_on(type);
+	surface_->print(x_, y_, text.substr(0, remaining_space));
 
 	x_ += std::min(unsigned(text.length()) + 1, remaining_space);
 
-	wattroff(win_, type);
+	surface_->effect_off(type);
 
 	return *this;
 }
@@ -177,11 +159,11 @@ ui::win::add_ascii_image(const ascii_image& img,
 	// Preload the x coordinates based on the value of pos
 	switch (pos) {
 	case left:
-		x_ = x_padding;
+		x_ = x_padding_;
 		break;
 
 	case right:
-		x_ = width_ - x_padding - img.width;
+		x_ = width_ - x_padding_ - img.width;
 		break;
 
 	case center:
@@ -193,16 +175,30 @@ ui::win::add_ascii_image(const ascii_image& img,
 		;// Nop
 	}
 
-	wattron(win_, type);
+	surface_->effect_on(type);
 
-	for (auto line : img.data) {
-		mvwprintw(win_, y_, x_, line.c_str());
+	for (const auto& line : img.data) {
+		surface_->print(x_, y_, std::string_view{line});
 		y_++;
 	}
 
-	wattroff(win_, type);
+	surface_->effect_off(type);
+
+	x_ = x_padding_;
+
+	return *this;
+}
+
+ui::win&
+ui::win::clear()
+{
+	surface_->clear_area();
+
+	if (framed_)
+		surface_->draw_border();
 
-	x_ = x_padding;
+	x_ = x_padding_;
+	y_ = y_padding_;
 
 	return *this;
 }
@@ -211,15 +207,15 @@ void
 ui::win::draw() const
 {
 	if (parent_)
-		touchwin(parent_->get_win());
+		parent_->get_surface().touch();
 
-	wrefresh(win_);
+	surface_->update();
 }
 
-WINDOW*
-ui::win::get_win() const
+ui::surface&
+ui::win::get_surface() const
 {
-	return win_;
+	return *surface_;
 }
 
 unsigned 
@@ -237,11 +233,11 @@ ui::win::cury() const
 unsigned 
 ui::win::max_width() const
 {
-	return width_ - 2*x_padding;
+	return width_ - 2*x_padding_;
 }
 
 unsigned
 ui::win::remaining_height() const
 {
-	return height_ - 2*y_padding - y_;
+	return height_ - 2*y_padding_ - y_;
 }
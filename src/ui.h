@@ -2,12 +2,16 @@
 
 #include <algorithm>
 #include <fstream>
+#include <memory>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <vector>
 
 #include <curses.h>
 
+#include "render_target.h"
+
 namespace ui {
 /* enum effect
  * Describes the effect of the rendered text. More than one effect can be
@@ -36,16 +40,34 @@ enum align { append,
 
 /* clear - clear the screen */
 void clear();
-/* screen_deinit - deinit the curses
+/* screen_deinit - deinit the screen
  *
- * This function frees the resources used by curses
+ * This function frees the resources used by curses if the terminal was used
+ * for drawing
  */
 void screen_deinit();
 /* screen_init - init curses
  *
- * This function inits curses library and sets it up for drawing
+ * This function inits curses library and sets it up for drawing on the
+ * terminal
  */
 void screen_init();
+/* screen_init - init a render target
+ * @target: pointer to the target to draw on
+ *
+ * This overload uses the target for drawing instead of the terminal. The
+ * caller owns the target and has to keep it alive until screen_deinit() is
+ * called.
+ */
+void screen_init(render_target* target);
+/* screen_resize - update the screen to its new size
+ *
+ * Returns a pair containing the new width and height of the screen
+ *
+ * This function should be called after the terminal has been resized
+ * (SIGWINCH). It clears the screen so that everything has to be redrawn.
+ */
+std::pair<unsigned, unsigned> screen_resize();
 /* screen_size - return the screen size
  *
  * Returns a pair containing the width and height of the screen
@@ -98,17 +120,19 @@ public:
 	 *
 	 * This ctor creates a new subwindwow (inside the parent window) between
 	 * from and to x,y-coordinates. The coordinates are from the top left
-	 * corner of the parent window
+	 * corner of the parent window. If framed is false the window is drawn
+	 * without a border and its contents start from the top left corner.
 	 */
 	win(win* parent,
 	    std::pair<unsigned, unsigned> from,
-	    std::pair<unsigned, unsigned> to);
+	    std::pair<unsigned, unsigned> to,
+	    const bool framed = true);
 
 	/* ~win - dtor
 	 * 
-	 * This function frees the curses window data
+	 * This function frees the surface of the window
 	 */
-	~win();
+	~win() = default;
 
 	/* newline - adds a newline
 	 *
@@ -136,7 +160,7 @@ public:
 	 * This function renders text to the window using the effect and position
 	 * defined
 	 */
-	win& add_text(const std::wstring& text,
+	win& add_text(std::wstring_view text,
 		      const unsigned type = normal,
 		      const unsigned pos = append);
 	/* add_ascii_image - add image to the window
@@ -154,17 +178,27 @@ public:
 			     const unsigned type = normal,
 			     const unsigned pos = append);
 
+	/* clear - clear this window
+	 *
+	 * Returns reference to a win object
+	 *
+	 * This function erases the contents of the window and moves the cursor
+	 * back to the top left corner so that the window can be reused
+	 */
+	win& clear();
+
 	/* draw - draw this window
 	 *
 	 * This function should be called when all of the contents is added
 	 * to render the window
 	 */
 	void draw() const;
-	/* get_win - get the underlaying ncurses window
+	/* get_surface - get the underlaying surface
 	 *
-	 * Returns a pointer to the underlaying ncurses window structure
+	 * Returns a reference to the surface of the render target this window
+	 * draws on
 	 */
-	WINDOW* get_win() const;
+	surface& get_surface() const;
 	/* curx - get the cursor x position
 	 *
 	 * Returns the current cursor x position inside the window. Value 0 means
@@ -189,14 +223,17 @@ public:
 	unsigned remaining_height() const;
 
 private:
-	static constexpr unsigned x_padding = 2;
-	static constexpr unsigned y_padding = 1;
+	static constexpr unsigned x_frame_padding = 2;
+	static constexpr unsigned y_frame_padding = 1;
 
+	bool framed_;
 	unsigned height_;
 	win* parent_;
+	std::unique_ptr<surface> surface_;
 	unsigned width_;
-	WINDOW* win_;
 	unsigned x_;
+	unsigned x_padding_;
 	unsigned y_;
+	unsigned y_padding_;
 };
 }
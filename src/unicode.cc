@@ -0,0 +1,171 @@
+#include "unicode.h"
+
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/* ascii_prefix - convert the leading ASCII characters
+ * @src: pointer to the utf-8 data
+ * @size: number of bytes
+ * @dst: pointer to space for at least size characters
+ *
+ * Returns the number of bytes converted. Conversion stops at the block
+ * containing the first non-ASCII byte, the rest is left to the decoder.
+ */
+static std::size_t ascii_prefix(const unsigned char* src,
+				std::size_t size,
+				wchar_t* dst);
+/* invalid - throw the error for invalid data */
+[[noreturn]] static void invalid();
+
+void
+util::append_utf8(std::wstring& dst, std::string_view src)
+{
+	const auto bytes = reinterpret_cast<const unsigned char*>(src.data());
+	const std::size_t size = src.size();
+	const std::size_t old_size = dst.size();
+
+	// A code point never takes more characters than bytes, so the
+	// string is grown once and shrunk to the decoded length at the end
+	dst.resize(old_size + size);
+
+	wchar_t* const begin = dst.data() + old_size;
+	wchar_t* out = begin;
+	std::size_t i = 0;
+
+	try {
+		while (i < size) {
+			if (bytes[i] < 0x80) {
+				const std::size_t count = ascii_prefix(bytes + i, size - i, out);
+
+				i += count;
+				out += count;
+
+				// Finish the run one byte at a time
+				while (i < size and bytes[i] < 0x80)
+					*out++ = bytes[i++];
+
+				continue;
+			}
+
+			std::uint32_t cp;
+			std::size_t length;
+			std::uint32_t min;
+
+			if ((bytes[i] & 0xe0) == 0xc0) {
+				cp = bytes[i] & 0x1f;
+				length = 2;
+				min = 0x80;
+			} else if ((bytes[i] & 0xf0) == 0xe0) {
+				cp = bytes[i] & 0x0f;
+				length = 3;
+				min = 0x800;
+			} else if ((bytes[i] & 0xf8) == 0xf0) {
+				cp = bytes[i] & 0x07;
+				length = 4;
+				min = 0x10000;
+			} else {
+				invalid();
+			}
+
+			if (size - i < length)
+				invalid();
+
+			for (std::size_t j = 1; j < length; j++) {
+				if ((bytes[i + j] & 0xc0) != 0x80)
+					invalid();
+
+				cp = (cp << 6) | (bytes[i + j] & 0x3f);
+			}
+
+			// Reject overlong forms, surrogates and values outside
+			// of the unicode range
+			if (cp < min or cp > 0x10ffff or (cp >= 0xd800 and cp <= 0xdfff))
+				invalid();
+
+			if constexpr (sizeof(wchar_t) == 2) {
+				if (cp >= 0x10000) {
+					cp -= 0x10000;
+					*out++ = static_cast<wchar_t>(0xd800 + (cp >> 10));
+					*out++ = static_cast<wchar_t>(0xdc00 + (cp & 0x3ff));
+					i += length;
+					continue;
+				}
+			}
+
+			*out++ = static_cast<wchar_t>(cp);
+			i += length;
+		}
+	} catch (...) {
+		dst.resize(old_size);
+		throw;
+	}
+
+	dst.resize(old_size + (out - begin));
+}
+
+std::wstring
+util::from_utf8(std::string_view src)
+{
+	std::wstring dst;
+
+	append_utf8(dst, src);
+
+	return dst;
+}
+
+static std::size_t
+ascii_prefix(const unsigned char* src, std::size_t size, wchar_t* dst)
+{
+	std::size_t i = 0;
+
+#if defined(__SSE2__)
+	if constexpr (sizeof(wchar_t) == 4) {
+		const __m128i zero = _mm_setzero_si128();
+
+		// Test 16 bytes at a time and widen them to 32 bits with two
+		// rounds of unpacking
+		for (; i + 16 <= size; i += 16) {
+			const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+			if (_mm_movemask_epi8(chunk) != 0)
+				return i;
+
+			const __m128i low = _mm_unpacklo_epi8(chunk, zero);
+			const __m128i high = _mm_unpackhi_epi8(chunk, zero);
+			auto out = reinterpret_cast<__m128i*>(dst + i);
+
+			_mm_storeu_si128(out + 0, _mm_unpacklo_epi16(low, zero));
+			_mm_storeu_si128(out + 1, _mm_unpackhi_epi16(low, zero));
+			_mm_storeu_si128(out + 2, _mm_unpacklo_epi16(high, zero));
+			_mm_storeu_si128(out + 3, _mm_unpackhi_epi16(high, zero));
+		}
+
+		return i;
+	}
+#endif
+
+	// Without SSE2 eight bytes are tested at a time in a 64-bit word
+	for (; i + 8 <= size; i += 8) {
+		std::uint64_t word;
+		std::memcpy(&word, src + i, sizeof(word));
+
+		if (word & 0x8080808080808080ull)
+			return i;
+
+		for (std::size_t j = 0; j < 8; j++)
+			dst[i + j] = src[i + j];
+	}
+
+	return i;
+}
+
+static void
+invalid()
+{
+	throw std::range_error{"invalid utf-8"};
+}
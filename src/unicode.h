@@ -0,0 +1,26 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+namespace util {
+	/* append_utf8 - decode utf-8 and append it to a wide string
+	 * @dst: the string to append to
+	 * @src: the utf-8 encoded data
+	 *
+	 * Decodes the whole buffer into code points, one wchar_t per code
+	 * point (or a surrogate pair where wchar_t is 16 bits). Runs of ASCII
+	 * are converted in bulk. Throws std::range_error if src is not valid
+	 * utf-8, i.e. it contains overlong forms, surrogates, code points
+	 * above U+10FFFF or truncated sequences. dst is left unchanged then.
+	 */
+	void append_utf8(std::wstring& dst, std::string_view src);
+
+	/* from_utf8 - decode utf-8 into a wide string
+	 * @src: the utf-8 encoded data
+	 *
+	 * Returns the decoded string. Throws std::range_error if src is not
+	 * valid utf-8.
+	 */
+	std::wstring from_utf8(std::string_view src);
+}
@@ -0,0 +1,189 @@
+#define BOOST_TEST_MODULE backend registry test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "backend_registry.h"
+#include "file_backend.h"
+#include "pipe_backend.h"
+
+static std::string read_json(const char* filename)
+{
+	std::ifstream in{filename, std::ios::in | std::ios::binary};
+	std::ostringstream contents;
+
+	contents << in.rdbuf();
+
+	return contents.str();
+}
+
+BOOST_AUTO_TEST_CASE(registry_test)
+{
+	events::backend_registry registry;
+
+	events::add_default_backends(registry);
+
+	BOOST_TEST(registry.contains("pop-api"));
+	BOOST_TEST(registry.contains("google-api"));
+	BOOST_TEST(registry.contains("file"));
+	BOOST_TEST(registry.contains("pipe"));
+	BOOST_TEST(not registry.contains("logo"));
+
+	//// Case 0: invalid arguments
+	BOOST_CHECK_THROW(registry.create("pop-api", {}), std::invalid_argument);
+	BOOST_CHECK_THROW(registry.create("pop-api", {"http://a", "x", "1"}),
+			  std::invalid_argument);
+	BOOST_CHECK_THROW(registry.create("google-api", {"id"}), std::invalid_argument);
+	BOOST_CHECK_THROW(registry.create("logo", {}), std::out_of_range);
+
+	//// Case 1: the keys of the same request match
+	const auto a = registry.create("pop-api", {"HTTP://Example.com/Calendar"});
+	const auto b = registry.create("pop-api", {"http://example.com/Calendar", "60", "10"});
+
+	BOOST_TEST(a.key == b.key);
+	BOOST_TEST(a.remote);
+	BOOST_TEST(a.key != registry.create("pop-api", {"http://example.com/calendar"}).key);
+
+	// The same request with different cooldowns conflicts
+	BOOST_TEST(a.settings != b.settings);
+	BOOST_TEST(a.settings == registry.create("pop-api", {"http://example.com/Calendar",
+							     "3600", "600"}).settings);
+
+	// So does the same Google calendar with a different API key
+	const auto c = registry.create("google-api", {"id", "key"});
+	const auto d = registry.create("google-api", {"id", "other key"});
+
+	BOOST_TEST(c.key == d.key);
+	BOOST_TEST(c.settings != d.settings);
+	BOOST_TEST(c.settings == registry.create("google-api", {"id", "key"}).settings);
+
+	//// Case 2: an option can be registered only once
+	BOOST_CHECK_THROW(events::add_default_backends(registry), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(canonical_url_test)
+{
+	BOOST_TEST(events::canonical_url("HTTPS://Host.Example/Path?Q=A") ==
+		   "https://host.example/Path?Q=A");
+	BOOST_TEST(events::canonical_url("HTTP://HOST") == "http://host");
+	BOOST_TEST(events::canonical_url("Not An Url") == "Not An Url");
+}
+
+/* future_json - read the test json with its events moved to 2099
+ *
+ * The backends skip events that have already ended
+ */
+static std::string future_json()
+{
+	std::string json = read_json("../test/test_json/working.json");
+
+	for (auto pos = json.find("\"2018-"); pos != std::string::npos;
+	     pos = json.find("\"2018-", pos))
+		json.replace(pos + 1, 4, "2099");
+
+	return json;
+}
+
+BOOST_AUTO_TEST_CASE(file_backend_test)
+{
+	constexpr char path[] = "backend_registry_test.json";
+	const std::string json = future_json();
+
+	std::remove(path);
+
+	events::file_backend backend{path};
+
+	//// Case 0: a missing file fails until it is written
+	BOOST_TEST(backend.ready());
+	BOOST_TEST(not backend.update().has_value());
+	backend.lower_cooldown();
+	BOOST_TEST(not backend.ready());
+
+	//// Case 1: the written file is read
+	{
+		std::ofstream out{path};
+		out << json;
+	}
+
+	BOOST_TEST(backend.ready());
+	BOOST_TEST(backend.update().value().size() == 2);
+	BOOST_TEST(not backend.ready());
+
+	std::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(stdin_pipe_test)
+{
+	events::backend_registry registry;
+
+	events::add_default_backends(registry);
+
+	const int saved_stdin = dup(STDIN_FILENO);
+
+	//// Case 0: the standard input is refused while it is a terminal
+	const int master = posix_openpt(O_RDWR | O_NOCTTY);
+
+	BOOST_TEST_REQUIRE(master >= 0);
+	BOOST_TEST(grantpt(master) == 0);
+	BOOST_TEST(unlockpt(master) == 0);
+
+	const int terminal = open(ptsname(master), O_RDWR | O_NOCTTY);
+
+	BOOST_TEST_REQUIRE(terminal >= 0);
+
+	dup2(terminal, STDIN_FILENO);
+
+	BOOST_CHECK_THROW(registry.create("pipe", {"-"}), std::invalid_argument);
+
+	close(terminal);
+	close(master);
+
+	//// Case 1: a redirected standard input is accepted
+	const int null = open("/dev/null", O_RDONLY);
+
+	dup2(null, STDIN_FILENO);
+
+	BOOST_CHECK_NO_THROW(registry.create("pipe", {"-"}));
+
+	close(null);
+
+	dup2(saved_stdin, STDIN_FILENO);
+	close(saved_stdin);
+}
+
+BOOST_AUTO_TEST_CASE(pipe_backend_test)
+{
+	constexpr char path[] = "backend_registry_test.fifo";
+	const std::string json = future_json();
+
+	std::remove(path);
+	BOOST_TEST(mkfifo(path, 0600) == 0);
+
+	events::pipe_backend backend{path};
+
+	BOOST_TEST(not backend.ready());
+
+	//// Case 0: data is parsed after the writer has closed the pipe
+	for (unsigned i = 0; i < 2; i++) {
+		const int fd = open(path, O_WRONLY);
+
+		BOOST_TEST(write(fd, json.data(), json.size()) == ssize_t(json.size()));
+		BOOST_TEST(not backend.ready());
+
+		close(fd);
+
+		BOOST_TEST(backend.ready());
+		BOOST_TEST(backend.update().value().size() == 2);
+		BOOST_TEST(not backend.ready());
+	}
+
+	std::remove(path);
+}
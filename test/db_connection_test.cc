@@ -1,7 +1,109 @@
 #define BOOST_TEST_MODULE db connection test
 #include <boost/test/unit_test.hpp>
 
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <string>
+#include <thread>
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
 #include "db_connection.h"
+#include "pop_calendar_backend.h"
+
+using namespace std::chrono;
+
+/* http_server class
+ * This class answers a single request on the loopback interface with a
+ * fixed response. An empty response is never sent, the connection is held
+ * open until the client gives up instead.
+ */
+class http_server {
+public:
+	http_server(std::string response) :
+		fd_{socket(AF_INET, SOCK_STREAM, 0)},
+		response_{std::move(response)}
+	{
+		sockaddr_in addr{};
+		socklen_t length = sizeof(addr);
+
+		addr.sin_family = AF_INET;
+		addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+
+		bind(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+		listen(fd_, 1);
+		getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &length);
+
+		port_ = ntohs(addr.sin_port);
+		thread_ = std::thread{&http_server::serve, this};
+	}
+
+	~http_server()
+	{
+		thread_.join();
+		close(fd_);
+	}
+
+	/* request - get the received request, valid after the transfer */
+	const std::string& request() const
+	{
+		return request_;
+	}
+
+	/* url - get the url of the server */
+	std::string url() const
+	{
+		return "http://127.0.0.1:" + std::to_string(port_) + "/";
+	}
+
+private:
+	/* wait - wait up to 5 seconds for a socket to become readable */
+	static bool wait(int fd)
+	{
+		pollfd p{fd, POLLIN, 0};
+
+		return poll(&p, 1, 5000) == 1;
+	}
+
+	void serve()
+	{
+		if (not wait(fd_))
+			return;
+
+		const int client = accept(fd_, nullptr, nullptr);
+		char buffer[4096];
+
+		while (request_.find("\r\n\r\n") == std::string::npos and wait(client)) {
+			const auto count = recv(client, buffer, sizeof(buffer), 0);
+
+			if (count <= 0)
+				break;
+
+			request_.append(buffer, count);
+		}
+
+		if (not response_.empty())
+			send(client, response_.data(), response_.size(), MSG_NOSIGNAL);
+
+		// Keep the connection open until the client closes it
+		while (wait(client) and recv(client, buffer, sizeof(buffer), 0) > 0)
+			;
+
+		close(client);
+	}
+
+	int fd_;
+	unsigned short port_;
+	std::string request_;
+	std::string response_;
+	std::thread thread_;
+};
 
 BOOST_AUTO_TEST_CASE(ctor_test)
 {
@@ -39,3 +141,199 @@ BOOST_AUTO_TEST_CASE(get_response_test)
 
 	BOOST_TEST(response.length() != 0);
 }
+
+BOOST_AUTO_TEST_CASE(response_cache_test)
+{
+	constexpr char dir[] = "db_connection_cache";
+	constexpr char file[] = "db_connection_test.txt";
+
+	const std::string request = std::string{"file://"} +
+				    std::filesystem::current_path().string() +
+				    '/' + file;
+
+	std::filesystem::create_directory(dir);
+
+	{
+		std::ofstream out{file};
+		out << "first";
+	}
+
+	events::db_connection c1;
+
+	c1.set_cache_dir(dir);
+	c1.set_request(request);
+
+	BOOST_TEST(c1.get_response() == "first");
+
+	const auto hash = c1.content_hash();
+
+	//// Case 0: the same content gives the same hash on a new connection
+	events::db_connection c2;
+
+	c2.set_cache_dir(dir);
+	c2.set_request(request);
+
+	BOOST_TEST(c2.get_response() == "first");
+	BOOST_TEST(c2.content_hash() == hash);
+
+	//// Case 1: changed content gives a new hash
+	{
+		std::ofstream out{file};
+		out << "second";
+	}
+
+	BOOST_TEST(c2.get_response() == "second");
+	BOOST_TEST(c2.content_hash() != hash);
+
+	std::remove(file);
+	std::filesystem::remove_all(dir);
+}
+
+BOOST_AUTO_TEST_CASE(compression_test)
+{
+	// "compressed body " repeated 64 times, compressed with gzip
+	static const std::string gzip_body{
+		"\x1f\x8b\x08\x00\x00\x00\x00\x00\x02\x03\x4b\xce\xcf\x2d\x28\x4a"
+		"\x2d\x2e\x4e\x4d\x51\x48\xca\x4f\xa9\x54\x48\x1e\xe5\x8f\xf2\x47"
+		"\xf9\x23\x86\x0f\x00\x36\x40\xc5\xe2\x00\x04\x00\x00", 45};
+
+	std::string expected;
+
+	for (unsigned i = 0; i < 64; i++)
+		expected += "compressed body ";
+
+	//// Case 0: gzip is offered and the body is decoded
+	{
+		http_server server{"HTTP/1.1 200 OK\r\n"
+				   "Content-Encoding: gzip\r\n"
+				   "Content-Length: 45\r\n"
+				   "Connection: close\r\n"
+				   "\r\n" + gzip_body};
+		events::db_connection c1;
+
+		c1.set_request(server.url());
+
+		BOOST_TEST(c1.get_response() == expected);
+		BOOST_TEST(server.request().find("Accept-Encoding:") != std::string::npos);
+		BOOST_TEST(server.request().find("gzip") != std::string::npos);
+	}
+
+	//// Case 1: the body is presized only up to a limit, a huge
+	//// Content-Length only makes the transfer fail as incomplete
+	{
+		http_server server{"HTTP/1.1 200 OK\r\n"
+				   "Content-Length: 4611686018427387904\r\n"
+				   "Connection: close\r\n"
+				   "\r\n"
+				   "short body"};
+		events::db_connection c1;
+
+		c1.set_request(server.url());
+
+		BOOST_CHECK_THROW(c1.get_response(), std::runtime_error);
+	}
+}
+
+BOOST_AUTO_TEST_CASE(error_test)
+{
+	//// Case 0: a failed transfer throws
+	events::db_connection c1;
+
+	c1.set_request("file:///nonexistent/db_connection_test.txt");
+
+	BOOST_CHECK_THROW(c1.get_response(), std::runtime_error);
+
+	//// Case 1: status classification
+	BOOST_TEST(events::http_error{503}.temporary());
+	BOOST_TEST(events::http_error{429}.temporary());
+	BOOST_TEST(events::http_error{408}.temporary());
+	BOOST_TEST(not events::http_error{404}.temporary());
+	BOOST_TEST(not events::http_error{403}.temporary());
+	BOOST_TEST(events::http_error{500}.status() == 500);
+}
+
+/* temporary - check that an http_error is temporary */
+static bool temporary(const events::http_error& e)
+{
+	return e.temporary();
+}
+
+BOOST_AUTO_TEST_CASE(timeout_test)
+{
+	//// Case 0: a stalled transfer is given up on as a temporary error
+	{
+		http_server server{""};
+		events::db_connection c1;
+
+		c1.set_request(server.url());
+		c1.set_low_speed_limit(1000, 1);
+
+		const auto start = steady_clock::now();
+
+		BOOST_CHECK_EXCEPTION(c1.get_response(), events::http_error, temporary);
+		BOOST_TEST((steady_clock::now() - start < seconds(4)));
+	}
+
+	//// Case 1: so is one exceeding the total timeout
+	{
+		http_server server{""};
+		events::db_connection c1;
+
+		c1.set_request(server.url());
+		c1.set_timeout(1);
+
+		const auto start = steady_clock::now();
+
+		BOOST_CHECK_EXCEPTION(c1.get_response(), events::http_error, temporary);
+		BOOST_TEST((steady_clock::now() - start < seconds(4)));
+	}
+}
+
+// Cancelling can't be undone, so this has to be the last test case
+BOOST_AUTO_TEST_CASE(cancel_test)
+{
+	//// Case 0: a transfer in progress is aborted
+	{
+		http_server server{""};
+		events::db_connection c1;
+
+		c1.set_request(server.url());
+
+		std::thread canceller{[]() {
+			std::this_thread::sleep_for(milliseconds(200));
+			events::db_connection::cancel_all();
+		}};
+
+		const auto start = steady_clock::now();
+
+		BOOST_CHECK_EXCEPTION(c1.get_response(), events::http_error, temporary);
+		BOOST_TEST((steady_clock::now() - start < seconds(4)));
+
+		canceller.join();
+	}
+
+	//// Case 1: the next request fails right away
+	events::db_connection c2;
+
+	c2.set_request("file:///nonexistent/db_connection_test.txt");
+
+	BOOST_CHECK_EXCEPTION(c2.get_response(), events::http_error, temporary);
+
+	//// Case 2: a backend retries after its error cooldown instead of
+	//// waiting for the normal one
+	events::pop_calendar_backend backend;
+
+	backend.set_url("file:///nonexistent/db_connection_test.ics");
+	backend.set_cooldown(3600);
+	backend.set_error_cooldown(1);
+
+	BOOST_TEST(not backend.update().has_value());
+
+	backend.lower_cooldown();
+
+	BOOST_TEST(not backend.ready());
+
+	std::this_thread::sleep_for(milliseconds(1100));
+
+	BOOST_TEST(backend.ready());
+}
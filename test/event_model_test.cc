@@ -1,59 +1,231 @@
-#define BOOST_TEST_MODULE event test
+#define BOOST_TEST_MODULE event model test
 #include <boost/test/unit_test.hpp>
 
-#include "db_connection.h"
+#include <algorithm>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <optional>
+
+#include "event_backend_interface.h"
 #include "event_model.h"
+#include "snapshot.h"
+
+using namespace std::chrono;
 
-namespace events {
-class mock_connection : public db_connection {
+/* fixed_backend class
+ * This class provides a fixed list of events once
+ */
+class fixed_backend : public events::event_backend_interface {
 public:
-	mock_connection();
+	fixed_backend(std::list<events::event> events) :
+		events_{std::move(events)},
+		updated_{false}
+	{}
 
-	std::string get_response() final;
-	{
-		//open json test file
-		//return the contents
-		return json_str;
-	}
+	void lower_cooldown() override
+	{}
 
-	void set_request(const std::string& request) final
+	std::optional<std::list<events::event>> update() override
 	{
-		request_ = request;
+		updated_ = true;
+
+		return events_;
 	}
 
-	std::string_view request() const final
+	bool ready() const override
 	{
-		return request;
+		return not updated_;
 	}
+
 private:
-	request
+	std::list<events::event> events_;
+	bool updated_;
 };
+
+/* names - get the names of events
+ * @events: the events
+ * @sorted: sort the names, the order of events that start at the same
+ *          time is not specified
+ */
+static std::vector<std::wstring> names(const std::vector<const events::event*>& events,
+					bool sorted = false)
+{
+	std::vector<std::wstring> result;
+
+	for (const auto* e : events)
+		result.emplace_back(e->name());
+
+	if (sorted)
+		std::sort(result.begin(), result.end());
+
+	return result;
+}
+
+BOOST_AUTO_TEST_CASE(query_test)
+{
+	// The model drops the events that have ended, so the events are in
+	// the future
+	const auto base = time_point_cast<seconds>(util::now()) + hours(24);
+
+	auto first = std::make_shared<fixed_backend>(std::list<events::event>{
+		{L"A", base, base + hours(1)},
+		{L"B", base + hours(2), base + hours(3)},
+		{L"All week", base, base + hours(24*7)}});
+	auto second = std::make_shared<fixed_backend>(std::list<events::event>{
+		{L"C", base + minutes(30), base + minutes(90)},
+		{L"D", base + hours(4), base + hours(5)}});
+
+	events::event_model model;
+	model.add_source(first);
+	model.add_source(second);
+
+	BOOST_TEST(model.update());
+	BOOST_TEST(model.events().size() == 5);
+
+	BOOST_TEST((names(model.overlapping(base + hours(1), base + hours(2))) ==
+		    std::vector<std::wstring>{L"All week", L"C"}));
+	BOOST_TEST(model.overlapping(base - hours(1), base).empty());
+
+	BOOST_TEST((names(model.in_progress(base + minutes(45)), true) ==
+		    std::vector<std::wstring>{L"A", L"All week", L"C"}));
+	BOOST_TEST((names(model.in_progress(base + hours(1))) ==
+		    std::vector<std::wstring>{L"All week", L"C"}));
+
+	BOOST_TEST((names(model.upcoming(base + hours(2), 2)) ==
+		    std::vector<std::wstring>{L"All week", L"B"}));
+	BOOST_TEST((names(model.upcoming(base, 10, {1})) ==
+		    std::vector<std::wstring>{L"C", L"D"}));
+	BOOST_TEST(model.upcoming(base, 0).empty());
 }
 
-BOOST_AUTO_TEST_CASE(ctor_test)
+BOOST_AUTO_TEST_CASE(merge_test)
 {
-	//// Case 0: no paramters
-	events::event_model m1;
-	
-	BOOST_TEST(m1.db() == nullptr);
-	
-	//// Case 1: valid db connection
-	events::mock_connection c;
-	events::event_model m2{&c};
-	
-	BOOST_TEST(m2.db() == &c);
-
-	//// Case 2: invalid db connection
-	BOOST_CHECK_THROW(events::event_model m3{nullptr}, std::runtime_error);
+	const auto base = time_point_cast<seconds>(util::now()) + hours(24);
+
+	// The all day event of one source overlaps every event of the other
+	auto first = std::make_shared<fixed_backend>(std::list<events::event>{
+		{L"Course", base, base + hours(24)},
+		{L"Lecture", base + hours(1), base + hours(2)}});
+	auto second = std::make_shared<fixed_backend>(std::list<events::event>{
+		{L"Lecture", base + hours(3), base + hours(4)},
+		{L"Lecture", base + minutes(90), base + hours(3)},
+		{L"Course", base + hours(20), base + hours(30)}});
+
+	events::event_model model;
+	model.add_source(first);
+	model.add_source(second);
+	model.update();
+
+	const auto& events = model.events();
+
+	// The lecture at 1:30 is combined with the one at 1:00. The one at
+	// 3:00 begins when the combined event ends, so it stays separate.
+	BOOST_TEST(events.size() == 3);
+	BOOST_TEST(events.front().name().data() == L"Course");
+	BOOST_TEST((events.front().end() == base + hours(30)));
+
+	BOOST_TEST((names(model.overlapping(base + hours(2), base + hours(3))) ==
+		    std::vector<std::wstring>{L"Course", L"Lecture"}));
+	BOOST_TEST((names(model.in_progress(base + hours(3))) ==
+		    std::vector<std::wstring>{L"Course", L"Lecture"}));
 }
 
-BOOST_AUTO_TEST_CASE(refresh_test)
+BOOST_AUTO_TEST_CASE(conflict_test)
 {
-	//TODO how to test
+	const auto base = time_point_cast<seconds>(util::now()) + hours(24);
+
+	std::list<events::event> list{
+		{L"A", base, base + hours(2)},
+		{L"B", base + hours(1), base + hours(3)},
+		{L"C", base + hours(2), base + hours(3)},
+		{L"D", base, base + hours(24)}};
+
+	auto it = list.begin();
+	(it++)->set_location(L"Room 1");
+	(it++)->set_location(L"Room 1");
+	(it++)->set_location(L"Room 2");
+	(it++)->set_location(L"Room 3");
+
+	events::event_model model;
+	model.add_source(std::make_shared<fixed_backend>(list));
+	model.set_conflict_hilight(true);
+	model.update();
+
+	std::vector<std::wstring> conflicts;
+
+	for (const auto& e : model.events())
+		if (e.conflict())
+			conflicts.emplace_back(e.name());
+
+	BOOST_TEST((conflicts == std::vector<std::wstring>{L"A", L"B"}));
 }
 
-BOOST_AUTO_TEST_CASE(iterator_test)
+BOOST_AUTO_TEST_CASE(shared_source_test)
 {
-	//
+	const auto base = time_point_cast<seconds>(util::now()) + hours(24);
+
+	// The same calendar is given as the first and the third source
+	auto shared = std::make_shared<fixed_backend>(std::list<events::event>{
+		{L"A", base, base + hours(1)},
+		{L"B", base + hours(2), base + hours(3)}});
+	auto other = std::make_shared<fixed_backend>(std::list<events::event>{
+		{L"C", base + hours(1), base + hours(2)}});
+
+	events::event_model model;
+	model.add_source(shared);
+	model.add_source(other);
+	model.add_source(shared);
+	model.add_hilight(2);
+	model.update();
+
+	// The events of the shared backend are merged once and highlighted by
+	// the rule of its second index
+	BOOST_TEST((names(model.upcoming(base, 10)) ==
+		    std::vector<std::wstring>{L"A", L"C", L"B"}));
+	BOOST_TEST(not shared->ready());
+
+	std::vector<std::wstring> hilighted;
+
+	for (const auto& e : model.events())
+		if (e.hilight())
+			hilighted.emplace_back(e.name());
+
+	BOOST_TEST((hilighted == std::vector<std::wstring>{L"A", L"B"}));
+
+	// The events keep the first index of their source
+	BOOST_TEST((names(model.upcoming(base, 10, {0})) ==
+		    std::vector<std::wstring>{L"A", L"B"}));
+	BOOST_TEST(model.upcoming(base, 10, {2}).empty());
 }
 
+BOOST_AUTO_TEST_CASE(description_test)
+{
+	constexpr char path[] = "event_model_test.snap";
+	const auto base = time_point_cast<seconds>(util::now()) + hours(24);
+
+	std::list<events::event> list{{L"A", base, base + hours(1)}};
+	list.front().set_description("Description \xc3\xa4");
+
+	//// Case 0: without a rule searching them the descriptions are dropped
+	events::event_model dropping;
+	dropping.add_source(std::make_shared<fixed_backend>(list));
+	dropping.update();
+
+	BOOST_TEST(dropping.events().front().description().empty());
+
+	//// Case 1: the descriptions are kept for the dumped events
+	events::event_model keeping;
+	keeping.add_source(std::make_shared<fixed_backend>(list));
+	keeping.set_keep_descriptions(true);
+	keeping.update();
+
+	events::save_snapshot(path, "info-tv", keeping.events());
+
+	const auto loaded = events::load_snapshot(path, "info-tv");
+
+	BOOST_TEST(loaded.size() == 1);
+	BOOST_TEST(loaded.front().description() == "Description \xc3\xa4");
+
+	std::remove(path);
+}
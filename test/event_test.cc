@@ -1,18 +1,16 @@
 #define BOOST_TEST_MODULE event test
 #include <boost/test/unit_test.hpp>
-#include <boost/date_time.hpp>
 
 #include "event.h"
 
-using namespace boost::gregorian;
-using namespace boost::posix_time;
+using namespace std::chrono;
 
 BOOST_AUTO_TEST_CASE(ctor_test)
 {
 	constexpr wchar_t event_name[] = L"event name";
 
-	const ptime start{date{2018, Jan, 1}, hours{12}};
-	const ptime end{date{2018, Jan, 2}, hours{16} + minutes{30}};
+	const auto start = util::from_utc({2018, 1, 1, 12, 0, 0});
+	const auto end = util::from_utc({2018, 1, 2, 16, 30, 0});
 
 	// Case 0: invalid duration
 	BOOST_CHECK_THROW(events::event(event_name, end, start),
@@ -21,7 +19,8 @@ BOOST_AUTO_TEST_CASE(ctor_test)
 	// Case 0: valid duration
 	events::event event{event_name, start, end};
 
-	BOOST_TEST((event.duration() == time_period(start, end)));
+	BOOST_TEST((event.start() == start));
+	BOOST_TEST((event.end() == end));
 	BOOST_TEST(event.name().data() == event_name);
 	BOOST_TEST(event.location().data() == L"");
 }
@@ -30,10 +29,10 @@ BOOST_AUTO_TEST_CASE(set_duration_test)
 {
 	constexpr wchar_t event_name[] = L"event name";
 
-	const ptime start1{date{2018, Jan, 2}, hours{14}};
-	const ptime end1{date{2018, Jan, 4}, hours{8} + minutes{45}};
-	const ptime start2{date{2018, Nov, 1}, hours{12} + minutes{30}};
-	const ptime end2{date{2018, Nov, 15}, hours{8}};
+	const auto start1 = util::from_utc({2018, 1, 2, 14, 0, 0});
+	const auto end1 = util::from_utc({2018, 1, 4, 8, 45, 0});
+	const auto start2 = util::from_utc({2018, 11, 1, 12, 30, 0});
+	const auto end2 = util::from_utc({2018, 11, 15, 8, 0, 0});
 	
 	events::event event1{event_name,
 			     start1,
@@ -43,12 +42,14 @@ BOOST_AUTO_TEST_CASE(set_duration_test)
 	BOOST_CHECK_THROW(event1.set_duration(end1, start1),
 			  std::logic_error);
 	
-	BOOST_CHECK_EQUAL(event1.duration(), time_period(start1, end1));
+	BOOST_TEST((event1.start() == start1));
+	BOOST_TEST((event1.end() == end1));
 
 	// Case 1: valid duration
 	event1.set_duration(start2, end2);
 
-	BOOST_CHECK_EQUAL(event1.duration(), time_period(start2, end2));
+	BOOST_TEST((event1.start() == start2));
+	BOOST_TEST((event1.end() == end2));
 }
 
 BOOST_AUTO_TEST_CASE(set_id)
@@ -56,8 +57,8 @@ BOOST_AUTO_TEST_CASE(set_id)
 	constexpr wchar_t event_name[] = L"event name";
 	constexpr char id[] = "X13fs4g";
 
-	const ptime start{date{2018, Jan, 2}, hours{14}};
-	const ptime end{date{2018, Jan, 4}, hours{8} + minutes{45}};
+	const auto start = util::from_utc({2018, 1, 2, 14, 0, 0});
+	const auto end = util::from_utc({2018, 1, 4, 8, 45, 0});
 
 	events::event event{event_name,
 			    start,
@@ -73,8 +74,8 @@ BOOST_AUTO_TEST_CASE(set_name_test)
 	constexpr wchar_t event_name1[] = L"event name";
 	constexpr wchar_t event_name2[] = L"another name";
 
-	const ptime start{date{2018, Jan, 2}, hours{14}};
-	const ptime end{date{2018, Jan, 4}, hours{8} + minutes{45}};
+	const auto start = util::from_utc({2018, 1, 2, 14, 0, 0});
+	const auto end = util::from_utc({2018, 1, 4, 8, 45, 0});
 
 	events::event event1{event_name1,
 			     start,
@@ -91,8 +92,8 @@ BOOST_AUTO_TEST_CASE(set_location_test)
 	constexpr wchar_t event_location1[] = L"event location";
 	constexpr wchar_t event_location2[] = L"new location";
 
-	const ptime start{date{2018, Jan, 2}, hours{14}};
-	const ptime end{date{2018, Jan, 4}, hours{8} + minutes{45}};
+	const auto start = util::from_utc({2018, 1, 2, 14, 0, 0});
+	const auto end = util::from_utc({2018, 1, 4, 8, 45, 0});
 
 	events::event event1{event_name,
 			     start,
@@ -106,3 +107,22 @@ BOOST_AUTO_TEST_CASE(set_location_test)
 
 	BOOST_TEST(event1.location().data() == event_location2);
 }
+
+BOOST_AUTO_TEST_CASE(set_description_test)
+{
+	constexpr wchar_t event_name[] = L"event name";
+
+	const auto start = util::from_utc({2018, 1, 2, 14, 0, 0});
+	const auto end = util::from_utc({2018, 1, 4, 8, 45, 0});
+
+	events::event event{event_name,
+			    start,
+			    end};
+
+	BOOST_TEST(event.description().empty());
+
+	// The description is kept as utf-8
+	event.set_description("Kuvaus \xc3\xa4");
+
+	BOOST_TEST(event.description() == "Kuvaus \xc3\xa4");
+}
@@ -6,15 +6,14 @@
 
 #include "google_calendar_backend.h"
 
-using namespace boost::gregorian;
-using namespace boost::posix_time;
+using namespace std::chrono;
 
 BOOST_AUTO_TEST_CASE(ctor)
 {
 	events::google_calendar_backend backend;
 
-	BOOST_CHECK_EQUAL(backend.cooldown(), hours(1));
-	BOOST_CHECK_EQUAL(backend.error_cooldown(), minutes(10));
+	BOOST_TEST((backend.cooldown() == hours(1)));
+	BOOST_TEST((backend.error_cooldown() == minutes(10)));
 	BOOST_TEST(backend.id().empty());
 	BOOST_TEST(backend.key().empty());
 }
@@ -52,7 +51,7 @@ BOOST_AUTO_TEST_CASE(set_cooldown_value_test)
 
 	backend.set_cooldown(600);
 
-	BOOST_CHECK_EQUAL(backend.cooldown(), minutes(10));
+	BOOST_TEST((backend.cooldown() == minutes(10)));
 }
 
 BOOST_AUTO_TEST_CASE(set_error_cooldown_value_test)
@@ -61,7 +60,7 @@ BOOST_AUTO_TEST_CASE(set_error_cooldown_value_test)
 
 	backend.set_error_cooldown(60);
 
-	BOOST_CHECK_EQUAL(backend.error_cooldown(), minutes(1));
+	BOOST_TEST((backend.error_cooldown() == minutes(1)));
 }
 
 BOOST_AUTO_TEST_CASE(set_id_test)
@@ -0,0 +1,142 @@
+#define BOOST_TEST_MODULE interval tree test
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <random>
+#include <tuple>
+#include <vector>
+
+#include "interval_tree.h"
+
+using namespace std::chrono;
+
+/* interval struct
+ * This struct is an interval stored in the tree and in a plain vector
+ */
+struct interval {
+	util::time_point start;
+	util::time_point end;
+	unsigned value;
+};
+
+/* find - find the overlapping intervals by scanning all of them */
+static std::vector<unsigned> find(const std::vector<interval>& intervals,
+				  util::time_point begin,
+				  util::time_point end)
+{
+	std::vector<interval> found;
+
+	for (const auto& i : intervals)
+		if (i.start < end and i.end > begin)
+			found.push_back(i);
+
+	std::sort(found.begin(), found.end(), [](const interval& a, const interval& b) {
+		return std::tie(a.start, a.value) < std::tie(b.start, b.value);
+	});
+
+	std::vector<unsigned> values;
+
+	for (const auto& i : found)
+		values.push_back(i.value);
+
+	return values;
+}
+
+/* find - find the overlapping intervals with the tree */
+static std::vector<unsigned> find(const util::interval_tree<unsigned>& tree,
+				  util::time_point begin,
+				  util::time_point end)
+{
+	std::vector<unsigned> values;
+
+	tree.overlapping(begin, end, [&values](util::time_point,
+					       util::time_point,
+					       unsigned value) {
+		values.push_back(value);
+		return true;
+	});
+
+	return values;
+}
+
+BOOST_AUTO_TEST_CASE(overlapping_test)
+{
+	const auto base = util::from_utc({2018, 1, 1, 0, 0, 0});
+
+	util::interval_tree<unsigned> tree;
+
+	tree.insert(base + hours(1), base + hours(2), 1);
+	tree.insert(base, base + hours(24*3), 2);
+	tree.insert(base + hours(3), base + hours(4), 3);
+
+	BOOST_TEST(tree.size() == 3);
+
+	// The end of an interval is not included in it
+	BOOST_TEST(find(tree, base + hours(2), base + hours(3)) == std::vector<unsigned>{2});
+	BOOST_TEST((find(tree, base + minutes(90), base + hours(5)) ==
+		    std::vector<unsigned>{2, 1, 3}));
+	BOOST_TEST(find(tree, base + hours(24*3), base + hours(24*4)).empty());
+
+	// The search stops when the function returns false
+	unsigned calls = 0;
+
+	BOOST_TEST(not tree.overlapping(base, base + hours(5),
+					[&calls](util::time_point,
+						 util::time_point,
+						 unsigned) {
+		return ++calls < 2;
+	}));
+	BOOST_TEST(calls == 2);
+
+	BOOST_TEST(tree.erase(base, 2));
+	BOOST_TEST(not tree.erase(base, 2));
+	BOOST_TEST(tree.size() == 2);
+	BOOST_TEST(find(tree, base + hours(2), base + hours(3)).empty());
+}
+
+BOOST_AUTO_TEST_CASE(random_test)
+{
+	const auto base = util::from_utc({2018, 1, 1, 0, 0, 0});
+
+	std::mt19937 rng{1};
+	std::uniform_int_distribution<int> start_dist{0, 10000};
+	std::uniform_int_distribution<int> length_dist{0, 500};
+
+	util::interval_tree<unsigned> tree;
+	std::vector<interval> intervals;
+
+	for (unsigned i = 0; i < 2000; i++) {
+		const auto start = base + minutes(start_dist(rng));
+		const auto end = start + minutes(length_dist(rng));
+
+		tree.insert(start, end, i);
+		intervals.push_back({start, end, i});
+	}
+
+	// Erase every third interval and reuse the nodes
+	for (unsigned i = 0; i < intervals.size(); i += 3)
+		BOOST_TEST(tree.erase(intervals[i].start, intervals[i].value));
+
+	std::vector<interval> kept;
+
+	for (unsigned i = 0; i < intervals.size(); i++)
+		if (i % 3)
+			kept.push_back(intervals[i]);
+
+	for (unsigned i = 0; i < 100; i++) {
+		const auto start = base + minutes(start_dist(rng));
+		const auto end = start + minutes(length_dist(rng));
+
+		tree.insert(start, end, 2000 + i);
+		kept.push_back({start, end, 2000 + i});
+	}
+
+	BOOST_TEST(tree.size() == kept.size());
+
+	for (unsigned i = 0; i < 200; i++) {
+		const auto begin = base + minutes(start_dist(rng));
+		const auto end = begin + minutes(length_dist(rng));
+
+		BOOST_TEST(find(tree, begin, end) == find(kept, begin, end));
+	}
+}
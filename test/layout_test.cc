@@ -0,0 +1,111 @@
+#define BOOST_TEST_MODULE layout test
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+
+#include "layout.h"
+
+class mock_view : public view_interface {
+public:
+	mock_view(unsigned height) :
+		height_{height}
+	{}
+
+	void draw(ui::win& win) const override
+	{}
+
+	unsigned height() const override
+	{
+		return height_;
+	}
+
+	unsigned height_;
+};
+
+BOOST_AUTO_TEST_CASE(single_column_test)
+{
+	mock_view top{6};
+	mock_view bottom{100};
+	ui::layout layout;
+
+	layout.add_view(&top, ui::layout::all_columns);
+	layout.add_view(&bottom);
+	layout.set_screen_size({80, 24});
+
+	const auto& regions = layout.regions();
+
+	BOOST_TEST(regions.size() == 2);
+
+	BOOST_TEST(regions[0].view == &top);
+	BOOST_TEST(regions[0].from.first == 2);
+	BOOST_TEST(regions[0].from.second == 1);
+	BOOST_TEST(regions[0].to.first == 74);
+	BOOST_TEST(regions[0].to.second == 7);
+
+	// The last view of the column gets the remaining space
+	BOOST_TEST(regions[1].view == &bottom);
+	BOOST_TEST(regions[1].from.second == 7);
+	BOOST_TEST(regions[1].to.second == 21);
+}
+
+BOOST_AUTO_TEST_CASE(multi_column_test)
+{
+	mock_view top{3};
+	mock_view left{10};
+	mock_view right{10};
+	ui::layout layout;
+
+	layout.set_columns(2, 30);
+	layout.add_view(&top, ui::layout::all_columns);
+	layout.add_view(&left, 0);
+	layout.add_view(&right, 1);
+
+	//// Case 0: both columns fit
+	layout.set_screen_size({128, 40});
+
+	auto regions = layout.regions();
+
+	BOOST_TEST(regions.size() == 3);
+	BOOST_TEST(regions[1].view == &left);
+	BOOST_TEST(regions[1].from.first == 2);
+	BOOST_TEST(regions[1].from.second == 4);
+	BOOST_TEST(regions[2].view == &right);
+	BOOST_TEST(regions[2].from.first > regions[1].to.first);
+	BOOST_TEST(regions[2].to.first == 122);
+
+	//// Case 1: screen too narrow for two columns
+	layout.set_screen_size({50, 40});
+
+	regions = layout.regions();
+
+	BOOST_TEST(regions.size() == 3);
+	BOOST_TEST(regions[1].view == &left);
+	BOOST_TEST(regions[1].to.second == 14);
+	BOOST_TEST(regions[2].view == &right);
+	BOOST_TEST(regions[2].from.first == 2);
+	BOOST_TEST(regions[2].from.second == 14);
+}
+
+BOOST_AUTO_TEST_CASE(content_change_test)
+{
+	mock_view top{3};
+	mock_view bottom{0};
+	ui::layout layout;
+
+	layout.add_view(&top, ui::layout::all_columns);
+	layout.add_view(&bottom);
+	layout.set_screen_size({80, 24});
+
+	BOOST_TEST(layout.regions()[1].from.second == 4);
+
+	top.height_ = 6;
+
+	BOOST_TEST(layout.regions()[1].from.second == 7);
+}
+
+BOOST_AUTO_TEST_CASE(set_columns_test)
+{
+	ui::layout layout;
+
+	BOOST_CHECK_THROW(layout.set_columns(0), std::invalid_argument);
+}
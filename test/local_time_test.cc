@@ -0,0 +1,85 @@
+#define BOOST_TEST_MODULE local time test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <ctime>
+
+#include "local_time.h"
+
+using namespace std::chrono;
+
+/* same - compare the date and time of day of civil times */
+static bool same(const util::civil_time& lhs, const util::civil_time& rhs)
+{
+	return lhs.year == rhs.year and lhs.month == rhs.month and
+	       lhs.day == rhs.day and lhs.hour == rhs.hour and
+	       lhs.minute == rhs.minute and lhs.second == rhs.second;
+}
+
+/* use_zone - change the local time zone */
+static void use_zone(const char* zone)
+{
+	setenv("TZ", zone, 1);
+	tzset();
+}
+
+BOOST_AUTO_TEST_CASE(utc_test)
+{
+	BOOST_TEST(util::from_utc({1970, 1, 1, 0, 0, 0}).time_since_epoch().count() == 0);
+	BOOST_TEST(util::from_utc({2018, 1, 2, 4, 15, 20}).time_since_epoch().count() == 1514866520);
+	BOOST_TEST(util::from_utc({1969, 12, 31, 23, 59, 59}).time_since_epoch().count() == -1);
+
+	// Round trips over leap days and the turn of a century
+	for (const auto& time : {util::civil_time{2000, 2, 29, 12, 0, 0},
+				 util::civil_time{2100, 3, 1, 0, 0, 1},
+				 util::civil_time{1969, 12, 31, 23, 59, 59},
+				 util::civil_time{2024, 12, 31, 23, 59, 59}})
+		BOOST_TEST(same(util::to_utc(util::from_utc(time)), time));
+
+	// 2018-01-02 was a Tuesday and 1970-01-01 a Thursday
+	BOOST_TEST(util::to_utc(util::from_utc({2018, 1, 2, 4, 15, 20})).weekday == 2);
+	BOOST_TEST(util::to_utc(util::from_utc({1970, 1, 1, 0, 0, 0})).weekday == 4);
+	BOOST_TEST(util::to_utc(util::from_utc({1969, 12, 28, 0, 0, 0})).weekday == 0);
+}
+
+BOOST_AUTO_TEST_CASE(local_test)
+{
+	use_zone("Europe/Helsinki");
+
+	// Winter and summer time
+	BOOST_TEST(same(util::to_local(util::from_utc({2018, 1, 2, 4, 15, 20})),
+			{2018, 1, 2, 6, 15, 20}));
+	BOOST_TEST(same(util::to_local(util::from_utc({2018, 7, 2, 4, 15, 20})),
+			{2018, 7, 2, 7, 15, 20}));
+	BOOST_TEST((util::from_local({2018, 1, 2, 6, 15, 20}) ==
+		    util::from_utc({2018, 1, 2, 4, 15, 20})));
+	BOOST_TEST((util::from_local({2018, 7, 2, 7, 15, 20}) ==
+		    util::from_utc({2018, 7, 2, 4, 15, 20})));
+
+	// The clocks were turned from 03:00 to 04:00 on 2018-03-25 and from
+	// 04:00 back to 03:00 on 2018-10-28
+	BOOST_TEST((util::from_local({2018, 3, 25, 2, 59, 59}) ==
+		    util::from_utc({2018, 3, 25, 0, 59, 59})));
+	BOOST_TEST((util::from_local({2018, 3, 25, 4, 0, 0}) ==
+		    util::from_utc({2018, 3, 25, 1, 0, 0})));
+	BOOST_TEST((util::from_local({2018, 3, 25, 3, 30, 0}) ==
+		    util::from_utc({2018, 3, 25, 1, 30, 0})));
+	BOOST_TEST((util::from_local({2018, 10, 28, 3, 30, 0}) ==
+		    util::from_utc({2018, 10, 28, 0, 30, 0})));
+	BOOST_TEST((util::from_local({2018, 10, 28, 4, 0, 0}) ==
+		    util::from_utc({2018, 10, 28, 2, 0, 0})));
+
+	use_zone("UTC0");
+
+	BOOST_TEST((util::from_local({2018, 7, 2, 7, 15, 20}) ==
+		    util::from_utc({2018, 7, 2, 7, 15, 20})));
+}
+
+BOOST_AUTO_TEST_CASE(now_test)
+{
+	const auto now = util::now();
+	const auto system = system_clock::now();
+
+	BOOST_TEST((now <= system));
+	BOOST_TEST((system - now < seconds(2)));
+}
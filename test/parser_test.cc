@@ -2,6 +2,7 @@
 #include <boost/test/unit_test.hpp>
 
 #include <cerrno>
+#include <algorithm>
 #include <fstream>
 #include <list>
 #include <string>
@@ -9,8 +10,6 @@
 #include "event.h"
 #include "parser.h"
 
-using namespace boost::gregorian;
-using namespace boost::posix_time;
 
 static std::string read_json(const char *filename)
 {
@@ -62,75 +61,61 @@ BOOST_AUTO_TEST_CASE(malformed_header_no_events)
 	BOOST_TEST(l.size() == 0);
 }
 
-BOOST_AUTO_TEST_CASE(malformed_events_kind)
+/* check_skipped - check that the malformed first event of a file is skipped
+ * @filename: the json file
+ */
+static void check_skipped(const char* filename)
 {
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_no_kind.json")),
-			  std::runtime_error);
+	std::size_t skipped;
 
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_wrong_kind.json")),
-			  std::runtime_error);
+	const auto l = events::parser::events_from_json(read_json(filename), {},
+							&skipped);
+
+	BOOST_TEST(skipped == 1);
+	BOOST_TEST(l.size() == 1);
+	BOOST_TEST(l.front().name().data() == L"Event 2");
+}
+
+BOOST_AUTO_TEST_CASE(malformed_events_kind)
+{
+	check_skipped("../test/test_json/event_no_kind.json");
+	check_skipped("../test/test_json/event_wrong_kind.json");
 }
 	
 BOOST_AUTO_TEST_CASE(malformed_events_status)
 {
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_no_status.json")),
-			  std::runtime_error);
-	
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_wrong_status.json")),
-			  std::runtime_error);
+	check_skipped("../test/test_json/event_no_status.json");
+	check_skipped("../test/test_json/event_wrong_status.json");
 }
 
 BOOST_AUTO_TEST_CASE(malformed_events_summary)
 {
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_no_summary.json")),
-			  std::runtime_error);
+	check_skipped("../test/test_json/event_no_summary.json");
 }
 	
 BOOST_AUTO_TEST_CASE(malformed_events_start)
 {
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_no_start.json")),
-			  std::runtime_error);
-
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_start_no_datetime.json")),
-			  std::runtime_error);
-
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_start_wrong_format_datetime.json")),
-			  std::runtime_error);
+	check_skipped("../test/test_json/event_no_start.json");
+	check_skipped("../test/test_json/event_start_no_datetime.json");
+	check_skipped("../test/test_json/event_start_wrong_format_datetime.json");
 	//TODO tests for date in start and format
 }
 	
 BOOST_AUTO_TEST_CASE(malformed_events_end)
 {
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_no_end.json")),
-			  std::runtime_error);
-	
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_end_no_datetime.json")),
-			  std::runtime_error);
-	
-	BOOST_CHECK_THROW(events::parser::events_from_json(
-			  read_json("../test/test_json/event_end_wrong_format_datetime.json")),
-			  std::runtime_error);
+	check_skipped("../test/test_json/event_no_end.json");
+	check_skipped("../test/test_json/event_end_no_datetime.json");
+	check_skipped("../test/test_json/event_end_wrong_format_datetime.json");
 	//TODO tests for date in start and format
 }
 
 BOOST_AUTO_TEST_CASE(valid_json)
 {
-	const time_period first_duration{ptime{date{2018, Jan, 1},
-					 hours(16) + minutes(30)},
-					 ptime{date{2018, Jan, 2},
-					 hours(4) + minutes(15) + seconds(20)}};
-	const time_period last_duration{ptime{date{2018, Jan, 2}},
-					ptime{date{2018, Jan, 4}}};
+	// The times have an offset of +03:00 and the dates are local
+	const auto first_start = util::from_utc({2018, 1, 1, 13, 30, 0});
+	const auto first_end = util::from_utc({2018, 1, 2, 1, 15, 20});
+	const auto last_start = util::from_local({2018, 1, 2, 0, 0, 0});
+	const auto last_end = util::from_local({2018, 1, 4, 0, 0, 0});
 
 	std::list<events::event> l;
 
@@ -140,11 +125,36 @@ BOOST_AUTO_TEST_CASE(valid_json)
 
 	BOOST_TEST(l.front().name().data() == L"Event 1");
 	BOOST_TEST(l.front().location().data() == L"Location A");
-	BOOST_CHECK_EQUAL(l.front().duration(), first_duration);
+	BOOST_TEST((l.front().start() == first_start));
+	BOOST_TEST((l.front().end() == first_end));
 
 	BOOST_TEST(l.back().name().data() == L"Event 2");
 	BOOST_TEST(l.back().location().data() == L"Location B");
-	BOOST_CHECK_EQUAL(l.back().duration(), last_duration);
+	BOOST_TEST((l.back().start() == last_start));
+	BOOST_TEST((l.back().end() == last_end));
+}
+
+BOOST_AUTO_TEST_CASE(json_offsets)
+{
+	const std::string json = R"({
+		"kind": "calendar#events",
+		"items": [
+			{
+				"kind": "calendar#event",
+				"status": "confirmed",
+				"summary": "Event",
+				"start": {"dateTime": "2018-01-01T13:30:00Z"},
+				"end": {"dateTime": "2018-01-01T12:00:00.250-05:00"}
+			}
+		]
+	})";
+
+	const auto l = events::parser::events_from_json(json);
+
+	BOOST_TEST(l.size() == 1);
+	// The fraction of the second is dropped
+	BOOST_TEST((l.front().start() == util::from_utc({2018, 1, 1, 13, 30, 0})));
+	BOOST_TEST((l.front().end() == util::from_utc({2018, 1, 1, 17, 0, 0})));
 }
 
 BOOST_AUTO_TEST_CASE(tentative_event)
@@ -155,3 +165,191 @@ BOOST_AUTO_TEST_CASE(tentative_event)
 
 	BOOST_TEST(l.size() == 0);
 }
+
+BOOST_AUTO_TEST_CASE(json_window)
+{
+	const auto l = events::parser::events_from_json(
+		read_json("../test/test_json/working.json"),
+		{util::from_utc({2018, 1, 2, 12, 0, 0})});
+
+	// The first event has ended before the window begins
+	BOOST_TEST(l.size() == 1);
+	BOOST_TEST(l.front().name().data() == L"Event 2");
+}
+
+static const std::string ics =
+	"BEGIN:VCALENDAR\r\n"
+	"PRODID:TUT.FI//POP-CALENDARSERVICE_V1.0//FI\r\n"
+	"VERSION:2.0\r\n"
+	"BEGIN:VEVENT\r\n"
+	"DTSTART;TZID=Europe/Helsinki:20180101T120000\r\n"
+	"DTEND;TZID=Europe/Helsinki:20180101T140000\r\n"
+	"SUMMARY:Event 1\r\n"
+	"LOCATION:Room A\\, Building B\r\n"
+	"UID:first\r\n"
+	"STATUS:CONFIRMED\r\n"
+	"BEGIN:VALARM\r\n"
+	"DESCRIPTION:Reminder\r\n"
+	"END:VALARM\r\n"
+	"DESCRIPTION:Description\r\n"
+	"END:VEVENT\r\n"
+	"BEGIN:VEVENT\r\n"
+	"DTSTART;TZID=Europe/Helsinki:20180102T120000\r\n"
+	"DTEND;TZID=Europe/Helsinki:20180102T140000\r\n"
+	"SUMMARY:Cancelled\r\n"
+	"STATUS:CANCELLED\r\n"
+	"END:VEVENT\r\n"
+	"BEGIN:VEVENT\r\n"
+	"DTSTART;TZID=Europe/Helsinki:20180103T120000\r\n"
+	"DTEND;TZID=Europe/Helsinki:20180103T140000\r\n"
+	"SUMMARY:Event 2\r\n"
+	"STATUS:CONFIRMED\r\n"
+	"END:VEVENT\r\n"
+	"END:VCALENDAR\r\n";
+
+BOOST_AUTO_TEST_CASE(valid_ics)
+{
+	const auto l = events::parser::events_from_ics(ics);
+
+	BOOST_TEST(l.size() == 2);
+
+	BOOST_TEST(l.front().name().data() == L"Event 1");
+	BOOST_TEST(l.front().location().data() == L"Room A, Building B");
+	BOOST_TEST(l.front().description() == "Description");
+	BOOST_TEST(l.front().id().data() == "first");
+	BOOST_TEST((l.front().start() == util::from_local({2018, 1, 1, 12, 0, 0})));
+	BOOST_TEST((l.front().end() == util::from_local({2018, 1, 1, 14, 0, 0})));
+
+	BOOST_TEST(l.back().name().data() == L"Event 2");
+}
+
+BOOST_AUTO_TEST_CASE(ics_window)
+{
+	const auto l = events::parser::events_from_ics(
+		ics, {util::from_local({2018, 1, 2, 0, 0, 0})});
+
+	BOOST_TEST(l.size() == 1);
+	BOOST_TEST(l.front().name().data() == L"Event 2");
+
+	const auto none = events::parser::events_from_ics(
+		ics, {util::from_local({2018, 1, 1, 0, 0, 0}),
+		      util::from_local({2018, 1, 1, 12, 0, 0})});
+
+	BOOST_TEST(none.size() == 0);
+}
+
+BOOST_AUTO_TEST_CASE(malformed_ics_events)
+{
+	const std::string data =
+		"BEGIN:VCALENDAR\r\n"
+		"PRODID:TUT.FI//POP-CALENDARSERVICE_V1.0//FI\r\n"
+		"VERSION:2.0\r\n"
+		"this is wrong\r\n"
+		"BEGIN:VEVENT\r\n"
+		"DTSTART;TZID=Europe/Helsinki:20180101T120000\r\n"
+		"DTEND;TZID=Europe/Helsinki:20180101T140000\r\n"
+		"SUMMARY:No colon\r\n"
+		"STATUS:CONFIRMED\r\n"
+		"this is wrong\r\n"
+		"END:VEVENT\r\n"
+		"BEGIN:VEVENT\r\n"
+		"DTSTART;TZID=Europe/Helsinki:2018-01-01T+03:00\r\n"
+		"DTEND;TZID=Europe/Helsinki:20180101T140000\r\n"
+		"SUMMARY:Bad time\r\n"
+		"STATUS:CONFIRMED\r\n"
+		"END:VEVENT\r\n"
+		"BEGIN:VEVENT\r\n"
+		"DTEND;TZID=Europe/Helsinki:20180101T140000\r\n"
+		"SUMMARY:No start\r\n"
+		"STATUS:CONFIRMED\r\n"
+		"END:VEVENT\r\n"
+		"BEGIN:VEVENT\r\n"
+		"DTSTART;TZID=Europe/Helsinki:20180101T120000\r\n"
+		"DTEND;TZID=Europe/Helsinki:20180101T140000\r\n"
+		"SUMMARY:Bad utf-8 \xff\r\n"
+		"STATUS:CONFIRMED\r\n"
+		"END:VEVENT\r\n"
+		"BEGIN:VEVENT\r\n"
+		"DTSTART;TZID=Europe/Helsinki:20180101T120000\r\n"
+		"DTEND;TZID=Europe/Helsinki:20180101T140000\r\n"
+		"SUMMARY:Event\r\n"
+		"STATUS:CONFIRMED\r\n"
+		"END:VEVENT\r\n"
+		"END:VCALENDAR\r\n";
+
+	std::size_t skipped;
+
+	const auto l = events::parser::events_from_ics(data, {}, 1, &skipped);
+
+	BOOST_TEST(skipped == 5);
+	BOOST_TEST(l.size() == 1);
+	BOOST_TEST(l.front().name().data() == L"Event");
+}
+
+BOOST_AUTO_TEST_CASE(malformed_ics)
+{
+	BOOST_CHECK_THROW(events::parser::events_from_ics("VERSION:2.0\r\n"),
+			  std::runtime_error);
+	BOOST_CHECK_THROW(events::parser::events_from_ics("BEGIN:VEVENT\r\n"),
+			  std::runtime_error);
+	BOOST_CHECK_THROW(events::parser::events_from_ics(
+			  "BEGIN:VCALENDAR\r\nVERSION:2.0\r\nEND:VCALENDAR\r\n"),
+			  std::runtime_error);
+}
+
+/* large_ics - generate icalendar data that is parsed in parallel
+ * @tail: lines added after the events
+ */
+static std::string large_ics(const std::string& tail)
+{
+	std::string data = "BEGIN:VCALENDAR\r\n"
+			   "PRODID:TUT.FI//POP-CALENDARSERVICE_V1.0//FI\r\n";
+
+	for (unsigned i = 0; i < 20000; i++) {
+		data += "BEGIN:VEVENT\r\n"
+			"DTSTART;TZID=Europe/Helsinki:20180101T120000\r\n"
+			"DTEND;TZID=Europe/Helsinki:20180101T140000\r\n"
+			"SUMMARY:Event " + std::to_string(i) + "\r\n"
+			"STATUS:CONFIRMED\r\n"
+			"END:VEVENT\r\n";
+	}
+
+	return data + tail;
+}
+
+BOOST_AUTO_TEST_CASE(parallel_ics)
+{
+	// The version is read by the last thread
+	const auto data = large_ics("VERSION:2.0\r\nEND:VCALENDAR\r\n");
+
+	const auto sequential = events::parser::events_from_ics(data);
+	const auto parallel = events::parser::events_from_ics(data, {}, 4);
+
+	BOOST_TEST(parallel.size() == 20000);
+	BOOST_TEST(parallel.size() == sequential.size());
+	BOOST_TEST(std::equal(parallel.begin(), parallel.end(), sequential.begin(),
+			      [](const events::event& a, const events::event& b) {
+		return a.name() == b.name();
+	}));
+}
+
+BOOST_AUTO_TEST_CASE(parallel_ics_errors)
+{
+	std::size_t skipped;
+
+	// The last part has a malformed event
+	const auto all = events::parser::events_from_ics(
+		large_ics("VERSION:2.0\r\nBEGIN:VEVENT\r\nSTATUS:CONFIRMED\r\n"
+			  "END:VEVENT\r\nEND:VCALENDAR\r\n"), {}, 4, &skipped);
+
+	BOOST_TEST(all.size() == 20000);
+	BOOST_TEST(skipped == 1);
+
+	// Nothing after the end of the calendar is read
+	const auto l = events::parser::events_from_ics(
+		"BEGIN:VCALENDAR\r\nVERSION:2.0\r\n"
+		"PRODID:TUT.FI//POP-CALENDARSERVICE_V1.0//FI\r\nEND:VCALENDAR\r\n" +
+		large_ics("this is wrong\r\n"), {}, 4);
+
+	BOOST_TEST(l.size() == 0);
+}
@@ -2,19 +2,26 @@
 #include <boost/test/unit_test.hpp>
 
 #include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <string>
 #include <thread>
 
 #include "pop_calendar_backend.h"
+#include "snapshot.h"
+#include "snapshot_backend.h"
 
-using namespace boost::gregorian;
-using namespace boost::posix_time;
+using namespace std::chrono;
 
 BOOST_AUTO_TEST_CASE(ctor)
 {
 	events::pop_calendar_backend backend;
 
-	BOOST_CHECK_EQUAL(backend.cooldown(), hours(1));
-	BOOST_CHECK_EQUAL(backend.error_cooldown(), minutes(10));
+	BOOST_TEST((backend.cooldown() == hours(1)));
+	BOOST_TEST((backend.error_cooldown() == minutes(10)));
 	BOOST_CHECK_EQUAL(backend.url(), "");
 }
 
@@ -51,7 +58,7 @@ BOOST_AUTO_TEST_CASE(set_cooldown_value_test)
 
 	backend.set_cooldown(600);
 
-	BOOST_CHECK_EQUAL(backend.cooldown(), minutes(10));
+	BOOST_TEST((backend.cooldown() == minutes(10)));
 }
 
 BOOST_AUTO_TEST_CASE(set_error_cooldown_value_test)
@@ -60,7 +67,7 @@ BOOST_AUTO_TEST_CASE(set_error_cooldown_value_test)
 
 	backend.set_error_cooldown(60);
 
-	BOOST_CHECK_EQUAL(backend.error_cooldown(), minutes(1));
+	BOOST_TEST((backend.error_cooldown() == minutes(1)));
 }
 
 BOOST_AUTO_TEST_CASE(set_url_test)
@@ -91,3 +98,119 @@ BOOST_AUTO_TEST_CASE(ready_test)
 
 	BOOST_TEST(not backend.ready());
 }
+
+/* feed - get an ics feed with a single event in 2099
+ * @name: name of the event
+ */
+static std::string feed(const std::string& name)
+{
+	return "BEGIN:VCALENDAR\r\n"
+	       "PRODID:TUT.FI//POP-CALENDARSERVICE_V1.0//FI\r\n"
+	       "VERSION:2.0\r\n"
+	       "BEGIN:VEVENT\r\n"
+	       "DTSTART;TZID=Europe/Helsinki:20990101T120000\r\n"
+	       "DTEND;TZID=Europe/Helsinki:20990101T140000\r\n"
+	       "SUMMARY:" + name + "\r\n"
+	       "STATUS:CONFIRMED\r\n"
+	       "END:VEVENT\r\n"
+	       "END:VCALENDAR\r\n";
+}
+
+BOOST_AUTO_TEST_CASE(parse_skip_test)
+{
+	constexpr char dir[] = "pop_calendar_backend_cache";
+	constexpr char file[] = "pop_calendar_backend_feed.ics";
+	constexpr char key[] = "pop:test";
+
+	const std::string url = std::string{"file://"} +
+				std::filesystem::current_path().string() +
+				'/' + file;
+	const std::string path = events::snapshot_path(dir, key);
+
+	// A backend set up like main does with a cache directory
+	const auto cached_backend = [&url, &dir, &key, &path]() {
+		auto backend = std::make_shared<events::pop_calendar_backend>();
+
+		backend->set_url(url);
+		backend->set_cache_dir(dir);
+
+		return std::make_shared<events::snapshot_backend>(backend, key, path);
+	};
+
+	std::filesystem::create_directory(dir);
+
+	{
+		std::ofstream out{file};
+		out << feed("Lecture");
+	}
+
+	//// Case 0: the snapshot keeps the hash of the parsed response
+	{
+		const auto backend = cached_backend();
+		const auto events = backend->update();
+
+		BOOST_TEST_REQUIRE(events.has_value());
+		BOOST_TEST(events->size() == 1);
+		BOOST_TEST((events->front().name() == L"Lecture"));
+	}
+
+	std::uint64_t hash = 0;
+	events::load_snapshot(path, key, &hash);
+
+	BOOST_TEST(hash != 0);
+
+	// Only the response cache and the snapshot are kept on disk
+	unsigned files = 0;
+
+	for (const auto& entry : std::filesystem::directory_iterator{dir}) {
+		BOOST_TEST((entry.path().extension() == ".resp" or
+			    entry.path().extension() == ".snap"));
+		files++;
+	}
+
+	BOOST_TEST(files == 2);
+
+	// Replace the stored events keeping the hash so that they can only be
+	// returned if the parser is skipped
+	const auto start = util::from_utc({2099, 1, 1, 10, 0, 0});
+
+	events::save_snapshot(path, key,
+			      {{L"From the cache", start, start + hours(2)}},
+			      hash);
+
+	//// Case 1: a new backend doesn't parse the same response again
+	{
+		const auto backend = cached_backend();
+
+		// The first update serves the snapshot, the second one
+		// fetches the calendar
+		backend->update();
+
+		const auto events = backend->update();
+
+		BOOST_TEST_REQUIRE(events.has_value());
+		BOOST_TEST(events->size() == 1);
+		BOOST_TEST((events->front().name() == L"From the cache"));
+	}
+
+	//// Case 2: a changed response is parsed
+	{
+		std::ofstream out{file};
+		out << feed("Exam");
+	}
+
+	{
+		const auto backend = cached_backend();
+
+		backend->update();
+
+		const auto events = backend->update();
+
+		BOOST_TEST_REQUIRE(events.has_value());
+		BOOST_TEST(events->size() == 1);
+		BOOST_TEST((events->front().name() == L"Exam"));
+	}
+
+	std::filesystem::remove_all(dir);
+	std::remove(file);
+}
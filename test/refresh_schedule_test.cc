@@ -0,0 +1,71 @@
+#define BOOST_TEST_MODULE refresh schedule test
+#include <boost/test/unit_test.hpp>
+
+#include "refresh_schedule.h"
+
+using namespace std::chrono;
+
+BOOST_AUTO_TEST_CASE(ctor_test)
+{
+	events::refresh_schedule schedule{hours(1), minutes(10)};
+
+	BOOST_TEST((schedule.cooldown() == hours(1)));
+	BOOST_TEST((schedule.error_cooldown() == minutes(10)));
+	BOOST_TEST(schedule.ready());
+	BOOST_TEST((schedule.wait() == seconds(0)));
+}
+
+BOOST_AUTO_TEST_CASE(jitter_test)
+{
+	events::refresh_schedule schedule{seconds(100), seconds(10)};
+
+	// The cooldown varies by up to 10% in both directions
+	for (unsigned i = 0; i < 100; i++) {
+		schedule.start();
+
+		BOOST_TEST(not schedule.ready());
+		BOOST_TEST((schedule.wait() > seconds(89)));
+		BOOST_TEST((schedule.wait() <= seconds(110)));
+	}
+}
+
+BOOST_AUTO_TEST_CASE(backoff_test)
+{
+	events::refresh_schedule schedule{seconds(100), seconds(10)};
+
+	//// Case 0: the error cooldown doubles with every failure
+	const seconds limits[] = {seconds(10), seconds(20), seconds(40),
+				  seconds(80), seconds(100), seconds(100)};
+
+	for (const auto& limit : limits) {
+		schedule.start();
+		schedule.fail();
+
+		BOOST_TEST((schedule.wait() >= limit/2 - seconds(1)));
+		BOOST_TEST((schedule.wait() <= limit));
+	}
+
+	//// Case 1: a success resets the backoff
+	schedule.start();
+	schedule.succeed();
+	schedule.start();
+	schedule.fail();
+
+	BOOST_TEST((schedule.wait() <= seconds(10)));
+}
+
+BOOST_AUTO_TEST_CASE(retry_after_test)
+{
+	events::refresh_schedule schedule{seconds(100), seconds(10)};
+
+	schedule.start();
+	schedule.retry_after(seconds(300));
+	schedule.fail();
+
+	BOOST_TEST((schedule.wait() > seconds(299)));
+
+	// A later update is not held back by an old delay
+	schedule.start();
+
+	BOOST_TEST((schedule.wait() <= seconds(110)));
+}
@@ -0,0 +1,187 @@
+#define BOOST_TEST_MODULE snapshot test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <list>
+#include <string>
+
+#include "event.h"
+#include "snapshot.h"
+#include "subscription_backend.h"
+
+using namespace std::chrono;
+
+constexpr char path[] = "snapshot_test.snap";
+
+BOOST_AUTO_TEST_CASE(round_trip_test)
+{
+	const auto start = util::from_utc({2018, 1, 1, 12, 0, 0});
+	const auto end = util::from_utc({2018, 1, 2, 16, 30, 0});
+
+	std::list<events::event> saved;
+
+	saved.emplace_back(L"First ävent", start, end);
+	saved.back().set_location(L"Location A");
+	saved.back().set_description("Description \xc3\xa4");
+	saved.back().set_id("id-1");
+	saved.emplace_back(L"Second event", end, end + hours{1});
+
+	events::save_snapshot(path, "key", saved);
+
+	const auto loaded = events::load_snapshot(path, "key");
+
+	BOOST_TEST(loaded.size() == 2);
+
+	BOOST_TEST((loaded.front().name() == L"First ävent"));
+	BOOST_TEST((loaded.front().location() == L"Location A"));
+	BOOST_TEST(loaded.front().description() == "Description \xc3\xa4");
+	BOOST_TEST(loaded.front().id() == "id-1");
+	BOOST_TEST((loaded.front().start() == start));
+	BOOST_TEST((loaded.front().end() == end));
+
+	BOOST_TEST((loaded.back().name() == L"Second event"));
+	BOOST_TEST(loaded.back().location().empty());
+	BOOST_TEST(loaded.back().id().empty());
+	BOOST_TEST((loaded.back().start() == end));
+	BOOST_TEST((loaded.back().end() == end + hours{1}));
+
+	std::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(wrong_key_test)
+{
+	events::save_snapshot(path, "key", {});
+
+	BOOST_TEST(events::load_snapshot(path, "key").empty());
+	BOOST_CHECK_THROW(events::load_snapshot(path, "other key"),
+			  std::runtime_error);
+
+	std::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(invalid_file_test)
+{
+	//// Case 0: missing file
+	BOOST_CHECK_THROW(events::load_snapshot("missing.snap", "key"),
+			  std::runtime_error);
+
+	//// Case 1: not a snapshot
+	{
+		std::ofstream out{path};
+		out << "this is not a snapshot file at all";
+	}
+
+	BOOST_CHECK_THROW(events::load_snapshot(path, "key"),
+			  std::runtime_error);
+
+	std::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(snapshot_path_test)
+{
+	const auto p1 = events::snapshot_path("/tmp", "pop:http://a");
+	const auto p2 = events::snapshot_path("/tmp", "pop:http://b");
+
+	BOOST_TEST(p1.rfind("/tmp/", 0) == 0);
+	BOOST_TEST(p1 != p2);
+	BOOST_TEST(p1 == events::snapshot_path("/tmp", "pop:http://a"));
+}
+
+BOOST_AUTO_TEST_CASE(reader_test)
+{
+	const auto start = util::from_utc({2018, 1, 1, 12, 0, 0});
+	const auto end = util::from_utc({2018, 1, 1, 14, 0, 0});
+
+	std::list<events::event> saved;
+
+	saved.emplace_back(L"Event", start, end);
+	saved.back().set_location(L"Room");
+	saved.back().set_description("\xc3\xa4");
+	saved.back().set_id("id");
+	saved.back().set_source(3);
+	saved.back().set_hilight(true);
+
+	events::save_snapshot(path, "key", saved);
+
+	{
+		const events::snapshot file{path};
+
+		BOOST_TEST(file.size() == 1);
+		BOOST_TEST(file.key() == "key");
+
+		const auto e = file.at(0);
+
+		BOOST_TEST((e.name == L"Event"));
+		BOOST_TEST((e.location == L"Room"));
+		BOOST_TEST(e.description == "\xc3\xa4");
+		BOOST_TEST(e.id == "id");
+		BOOST_TEST(e.source == 3);
+		BOOST_TEST(e.hilight);
+		BOOST_TEST((e.start == start));
+		BOOST_TEST((e.end == end));
+
+		BOOST_CHECK_THROW(file.at(1), std::out_of_range);
+	}
+
+	// The records are read in place, so they have to start at an offset
+	// aligned for their 64-bit times. The offset follows the magic, the
+	// version and the character size in the header.
+	{
+		std::ifstream in{path, std::ios::in | std::ios::binary};
+		char header[20];
+		std::uint32_t records_offset;
+
+		in.read(header, sizeof(header));
+		std::memcpy(&records_offset, header + 16, sizeof(records_offset));
+
+		BOOST_TEST(records_offset >= 40);
+		BOOST_TEST(records_offset % alignof(std::int64_t) == 0);
+	}
+
+	// The source and the highlight survive a round trip as well
+	const auto loaded = events::load_snapshot(path, "key");
+
+	BOOST_TEST(loaded.front().source() == 3);
+	BOOST_TEST(loaded.front().hilight());
+
+	std::remove(path);
+}
+
+BOOST_AUTO_TEST_CASE(subscription_test)
+{
+	const auto start = util::from_utc({2018, 1, 1, 12, 0, 0});
+
+	std::list<events::event> published;
+
+	published.emplace_back(L"Event", start, start + hours{1});
+	published.back().set_hilight(true);
+
+	events::subscription_backend backend{path};
+
+	//// Case 0: nothing has been published
+	BOOST_TEST(not backend.ready());
+
+	//// Case 1: the published events are read once
+	events::save_snapshot(path, "info-tv", published);
+
+	BOOST_TEST(backend.ready());
+
+	const auto events = backend.update();
+
+	BOOST_TEST(events.has_value());
+	BOOST_TEST(events.value().size() == 1);
+	BOOST_TEST(events.value().front().hilight());
+	BOOST_TEST(not backend.ready());
+
+	//// Case 2: a new snapshot is read again
+	published.emplace_back(L"Second", start, start + hours{2});
+	events::save_snapshot(path, "info-tv", published);
+
+	BOOST_TEST(backend.ready());
+	BOOST_TEST(backend.update().value().size() == 2);
+
+	std::remove(path);
+}
@@ -7,13 +7,13 @@
 
 BOOST_AUTO_TEST_CASE(system_time_test)
 {
-	const ptime time{date{2018, Jan, 1}};
+	const auto time = util::from_utc({2018, 1, 1, 0, 0, 0});
 
 	util::status_view status;
 
 	status.set_system_time(time);
 
-	BOOST_CHECK_EQUAL(status.system_time(), time);
+	BOOST_TEST((status.system_time() == time));
 }
 
 BOOST_AUTO_TEST_CASE(system_message_test)
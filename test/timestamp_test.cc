@@ -0,0 +1,120 @@
+#define BOOST_TEST_MODULE timestamp test
+#include <boost/test/unit_test.hpp>
+
+#include <cstdlib>
+#include <ctime>
+#include <stdexcept>
+
+#include "timestamp.h"
+
+using events::parser::parse_timestamp;
+
+/* same - compare the date and time of day of civil times */
+static bool same(const util::civil_time& lhs, const util::civil_time& rhs)
+{
+	return lhs.year == rhs.year and lhs.month == rhs.month and
+	       lhs.day == rhs.day and lhs.hour == rhs.hour and
+	       lhs.minute == rhs.minute and lhs.second == rhs.second;
+}
+
+BOOST_AUTO_TEST_CASE(extended_test)
+{
+	events::parser::timestamp t;
+
+	BOOST_TEST(parse_timestamp("2018-01-02T04:15:20+03:00", t));
+	BOOST_TEST(same(t.time, {2018, 1, 2, 4, 15, 20}));
+	BOOST_TEST(t.offset == 3*3600);
+	BOOST_TEST(t.absolute);
+
+	BOOST_TEST(parse_timestamp("2018-01-02T04:15:20-09:30", t));
+	BOOST_TEST(t.offset == -(9*3600 + 30*60));
+
+	BOOST_TEST(parse_timestamp("2018-01-02t04:15:20z", t));
+	BOOST_TEST(t.offset == 0);
+	BOOST_TEST(t.absolute);
+
+	BOOST_TEST(parse_timestamp("2018-01-02 04:15:20", t));
+	BOOST_TEST(not t.absolute);
+}
+
+BOOST_AUTO_TEST_CASE(fraction_test)
+{
+	events::parser::timestamp t;
+
+	BOOST_TEST(parse_timestamp("2018-01-02T04:15:20.5Z", t));
+	BOOST_TEST(t.fraction == 500000);
+
+	BOOST_TEST(parse_timestamp("2018-01-02T04:15:20.123456789+01:00", t));
+	BOOST_TEST(t.fraction == 123456);
+
+	BOOST_TEST(not parse_timestamp("2018-01-02T04:15:20.Z", t));
+}
+
+BOOST_AUTO_TEST_CASE(basic_test)
+{
+	events::parser::timestamp t;
+
+	BOOST_TEST(parse_timestamp("20180102T041520", t));
+	BOOST_TEST(same(t.time, {2018, 1, 2, 4, 15, 20}));
+	BOOST_TEST(not t.absolute);
+
+	BOOST_TEST(parse_timestamp("20180102T041520Z", t));
+	BOOST_TEST(t.absolute);
+
+	BOOST_TEST(parse_timestamp("20180102T041520+0200", t));
+	BOOST_TEST(t.offset == 2*3600);
+
+	BOOST_TEST(parse_timestamp("20180102", t));
+	BOOST_TEST(same(t.time, {2018, 1, 2, 0, 0, 0}));
+}
+
+BOOST_AUTO_TEST_CASE(date_test)
+{
+	events::parser::timestamp t;
+
+	BOOST_TEST(parse_timestamp("2020-02-29", t));
+	BOOST_TEST(same(t.time, {2020, 2, 29, 0, 0, 0}));
+	BOOST_TEST(not t.absolute);
+
+	BOOST_TEST(not parse_timestamp("2019-02-29", t));
+	BOOST_TEST(not parse_timestamp("2100-02-29", t));
+	BOOST_TEST(not parse_timestamp("2018-13-01", t));
+	BOOST_TEST(not parse_timestamp("2018-04-31", t));
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test)
+{
+	events::parser::timestamp t;
+
+	BOOST_TEST(not parse_timestamp("", t));
+	BOOST_TEST(not parse_timestamp("2018-01T16:30:00+03:00", t));
+	BOOST_TEST(not parse_timestamp("2018-01-02T+03:00", t));
+	BOOST_TEST(not parse_timestamp("2018-01-02T24:00:00", t));
+	BOOST_TEST(not parse_timestamp("2018-01-02T04:15:20+03:00 ", t));
+	BOOST_TEST(not parse_timestamp("2018-01-02T04:15:20+3", t));
+	BOOST_TEST(not parse_timestamp("2018-0102", t));
+	BOOST_TEST(not parse_timestamp("20180102 041520", t));
+}
+
+BOOST_AUTO_TEST_CASE(time_point_test)
+{
+	using events::parser::to_time_point;
+
+	BOOST_TEST((to_time_point("2018-01-02T04:15:20+03:00") ==
+		    util::from_utc({2018, 1, 2, 1, 15, 20})));
+	BOOST_TEST((to_time_point("2018-01-01T22:00:00-03:00") ==
+		    util::from_utc({2018, 1, 2, 1, 0, 0})));
+	BOOST_TEST((to_time_point("20180102T041520Z") ==
+		    util::from_utc({2018, 1, 2, 4, 15, 20})));
+
+	// Times without an offset are local
+	setenv("TZ", "Europe/Helsinki", 1);
+	tzset();
+
+	BOOST_TEST((to_time_point("20180102T041520") ==
+		    util::from_utc({2018, 1, 2, 2, 15, 20})));
+	BOOST_TEST((to_time_point("2018-07-02") ==
+		    util::from_utc({2018, 7, 1, 21, 0, 0})));
+
+	BOOST_CHECK_THROW(to_time_point("tomorrow"), std::runtime_error);
+}
@@ -0,0 +1,91 @@
+#define BOOST_TEST_MODULE ui test
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include "buffer_target.h"
+#include "ui.h"
+
+BOOST_AUTO_TEST_CASE(no_target_test)
+{
+	ui::screen_deinit();
+
+	BOOST_CHECK_THROW(ui::screen_size(), std::logic_error);
+	BOOST_CHECK_THROW((ui::win{{0, 0}, {10, 10}}), std::logic_error);
+}
+
+BOOST_AUTO_TEST_CASE(buffer_target_test)
+{
+	ui::buffer_target target{{20, 10}};
+
+	ui::screen_init(&target);
+
+	BOOST_TEST((ui::screen_size() == std::pair{20u, 10u}));
+	BOOST_TEST((target.line(0) == std::wstring(20, L' ')));
+	BOOST_CHECK_THROW(target.line(10), std::out_of_range);
+	BOOST_CHECK_THROW(target.at(20, 0), std::out_of_range);
+
+	target.set_size({30, 5});
+
+	BOOST_TEST((ui::screen_resize() == std::pair{30u, 5u}));
+
+	ui::screen_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(win_test)
+{
+	ui::buffer_target target{{20, 6}};
+
+	ui::screen_init(&target);
+
+	{
+		ui::win main_win{{0, 0}, {20, 6}};
+
+		main_win.add_text(L"left", ui::effect::bold)
+			.newline()
+			.add_text(L"right", ui::effect::normal, ui::align::right)
+			.newline()
+			.add_text(L"this text is too long to fit");
+		main_win.draw();
+	}
+
+	BOOST_TEST((target.line(0) == L"+------------------+"));
+	BOOST_TEST((target.line(1) == L"| left             |"));
+	BOOST_TEST((target.line(2) == L"|            right |"));
+	BOOST_TEST((target.line(3) == L"| this text is too |"));
+	BOOST_TEST((target.line(5) == L"+------------------+"));
+
+	BOOST_TEST(target.at(2, 1).attrs == ui::effect::bold);
+	BOOST_TEST(target.at(13, 2).attrs == ui::effect::normal);
+	BOOST_TEST(target.refresh_count() == 1);
+
+	ui::screen_deinit();
+}
+
+BOOST_AUTO_TEST_CASE(subwin_test)
+{
+	ui::buffer_target target{{20, 8}};
+
+	ui::screen_init(&target);
+
+	{
+		ui::win main_win{{0, 0}, {20, 8}};
+		ui::win sub_win{&main_win,
+				{main_win.curx(), main_win.cury()},
+				{main_win.curx() + main_win.max_width(),
+				 main_win.cury() + 3}};
+
+		sub_win.add_text(L"sub", ui::effect::normal, ui::align::center);
+
+		BOOST_TEST(main_win.cury() == 4);
+
+		sub_win.clear();
+	}
+
+	BOOST_TEST((target.line(1) == L"| +--------------+ |"));
+	BOOST_TEST((target.line(2) == L"| |              | |"));
+	BOOST_TEST((target.line(3) == L"| +--------------+ |"));
+
+	ui::screen_deinit();
+}
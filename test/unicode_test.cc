@@ -0,0 +1,65 @@
+#define BOOST_TEST_MODULE unicode test
+#include <boost/test/unit_test.hpp>
+
+#include <stdexcept>
+#include <string>
+
+#include "unicode.h"
+
+BOOST_AUTO_TEST_CASE(ascii_test)
+{
+	BOOST_TEST(util::from_utf8("").empty());
+	BOOST_TEST((util::from_utf8("a") == L"a"));
+
+	// Long enough to cross several 16 byte blocks with a tail
+	std::string input;
+	std::wstring expected;
+
+	for (unsigned i = 0; i < 100; i++) {
+		input.push_back(static_cast<char>(' ' + i % 90));
+		expected.push_back(static_cast<wchar_t>(' ' + i % 90));
+	}
+
+	BOOST_TEST((util::from_utf8(input) == expected));
+}
+
+BOOST_AUTO_TEST_CASE(multibyte_test)
+{
+	BOOST_TEST((util::from_utf8("\xc3\xa4") == L"ä"));
+	BOOST_TEST((util::from_utf8("\xe2\x82\xac") == L"€"));
+	BOOST_TEST((util::from_utf8("\xf0\x9f\x98\x80") == L"\U0001f600"));
+
+	// Non-ASCII right after a full block of ASCII and in the middle
+	BOOST_TEST((util::from_utf8("Kokoushuone 1234\xc3\xa4 ja Sali \xe2\x82\xac") ==
+		   L"Kokoushuone 1234ä ja Sali €"));
+}
+
+BOOST_AUTO_TEST_CASE(append_test)
+{
+	std::wstring dst = L"prefix ";
+
+	util::append_utf8(dst, "\xc3\xa4iti");
+	BOOST_TEST((dst == L"prefix äiti"));
+
+	// The string is left as it was if the input is invalid
+	BOOST_CHECK_THROW(util::append_utf8(dst, "abc\xff"), std::range_error);
+	BOOST_TEST((dst == L"prefix äiti"));
+}
+
+BOOST_AUTO_TEST_CASE(invalid_test)
+{
+	// Overlong forms
+	BOOST_CHECK_THROW(util::from_utf8("\xc0\x80"), std::range_error);
+	BOOST_CHECK_THROW(util::from_utf8("\xe0\x80\x80"), std::range_error);
+	BOOST_CHECK_THROW(util::from_utf8("\xf0\x80\x80\x80"), std::range_error);
+	// Surrogates
+	BOOST_CHECK_THROW(util::from_utf8("\xed\xa0\x80"), std::range_error);
+	// Above U+10FFFF
+	BOOST_CHECK_THROW(util::from_utf8("\xf4\x90\x80\x80"), std::range_error);
+	BOOST_CHECK_THROW(util::from_utf8("\xf5\x80\x80\x80"), std::range_error);
+	// Truncated sequences and lone continuation bytes
+	BOOST_CHECK_THROW(util::from_utf8("\xe2\x82"), std::range_error);
+	BOOST_CHECK_THROW(util::from_utf8("abc\xf0\x9f\x98"), std::range_error);
+	BOOST_CHECK_THROW(util::from_utf8("\x80"), std::range_error);
+	BOOST_CHECK_THROW(util::from_utf8("\xc3\x28"), std::range_error);
+}